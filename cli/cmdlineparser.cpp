@@ -253,6 +253,10 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
             _settings->_xml = true;
         }
 
+        // Write results in JSON Lines format
+        else if (strcmp(argv[i], "--json") == 0)
+            _settings->_json = true;
+
         // Only print something when there are errors
         else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0)
             _settings->_errorsOnly = true;
@@ -268,6 +272,22 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
             }
         }
 
+        // Keep the analysis data between runs
+        else if (strncmp(argv[i], "--analysis-file=", 16) == 0)
+            _settings->analysisFile = 16 + argv[i];
+
+        // Keep the results of the files between runs
+        else if (strncmp(argv[i], "--cache-file=", 13) == 0)
+            _settings->cacheFile = 13 + argv[i];
+
+        // Keep the check time of each file between runs
+        else if (strncmp(argv[i], "--cost-file=", 12) == 0)
+            _settings->costFile = 12 + argv[i];
+
+        // Write the progress in JSON format to a file
+        else if (strncmp(argv[i], "--progress-file=", 16) == 0)
+            _settings->progressFile = 16 + argv[i];
+
         // Append userdefined code to checked source code
         else if (strncmp(argv[i], "--append=", 9) == 0)
             _settings->append(9 + argv[i]);
@@ -604,12 +624,6 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
         PrintMessage("unusedFunctions check can't be used with -j option, so it was disabled.");
     }
 
-    // FIXME: Make the _settings.test_2_pass thread safe
-    if (_settings->test_2_pass && _settings->_jobs > 1)
-    {
-        PrintMessage("--test-2-pass doesn't work with -j option yet.");
-    }
-
     if (argc <= 1)
         _showHelp = true;
 
@@ -639,8 +653,20 @@ void CmdLineParser::PrintHelp()
               "If path is given instead of filename, *.cpp, *.cxx, *.cc, *.c++ and *.c files\n"
               "are checked recursively from given directory.\n\n"
               "Options:\n"
+              "    --analysis-file=<file>\n"
+              "                         Read the analysis data of an earlier run from the\n"
+              "                         file and write the updated data back to it. The\n"
+              "                         data of files that have changed is dropped.\n"
               "    --append=<file>      This allows you to provide information about\n"
               "                         functions by providing an implementation for these.\n"
+              "    --cache-file=<file>  Keep the results of each file in the file. A file is\n"
+              "                         not checked again if it and the headers that it\n"
+              "                         includes have not changed since the last run. Not\n"
+              "                         used with --inline-suppr or unusedFunction.\n"
+              "    --cost-file=<file>   Read the check time of each file in an earlier run\n"
+              "                         from the file and write the new times back to it.\n"
+              "                         When -j is used the files that take the longest time\n"
+              "                         are checked first.\n"
               "    -D<ID>               By default Cppcheck checks all configurations.\n"
               "                         Use -D to limit the checking. When -D is used the\n"
               "                         checking is limited to the given configuration.\n"
@@ -677,7 +703,18 @@ void CmdLineParser::PrintHelp()
               "    --inline-suppr       Enable inline suppressions. Use them by placing one or\n"
               "                         more comments, like: // cppcheck-suppress warningId\n"
               "                         on the lines before the warning to suppress.\n"
+              "    --json               Write results to error stream in JSON Lines format,\n"
+              "                         one JSON object per error.\n"
               "    -j <jobs>            Start [jobs] threads to do the checking simultaneously.\n"
+              "                         The files are checked in parallel. When exactly one\n"
+              "                         file is given, the checks of that file are run in\n"
+              "                         parallel instead. That is not done with --showtime.\n"
+              "    --progress-file=<file>\n"
+              "                         Write the progress to the file in JSON Lines format:\n"
+              "                         the stage of each file that is checked, and the\n"
+              "                         number of checked files and bytes, the throughput\n"
+              "                         and the estimated time left each time the checked\n"
+              "                         percentage changes.\n"
               "    -q, --quiet          Only print error messages.\n"
               "    --report-progress    Report progress messages while checking a file.\n"
               "    --rule=<rule>        Match regular expression.\n"
@@ -31,11 +31,15 @@ CppCheckExecutor::CppCheckExecutor()
 {
     time1 = 0;
     errorlist = false;
+    _reportLimit = 65536;
+    _progressStart = 0;
+    _progressValue = 0;
+    _statusPercent = -1;
 }
 
 CppCheckExecutor::~CppCheckExecutor()
 {
-
+    flushReport();
 }
 
 bool CppCheckExecutor::parseFromArgs(CppCheck *cppcheck, int argc, const char* const argv[])
@@ -86,24 +90,33 @@ bool CppCheckExecutor::parseFromArgs(CppCheck *cppcheck, int argc, const char* c
     std::vector<std::string> pathnames = parser.GetPathNames();
     std::vector<std::string> filenames;
     std::map<std::string, long> filesizes;
+    PathMatch matcher(parser.GetIgnoredPaths());
 
     if (!pathnames.empty())
     {
         // Execute recursiveAddFiles() to each given file parameter
         std::vector<std::string>::const_iterator iter;
         for (iter = pathnames.begin(); iter != pathnames.end(); ++iter)
-            FileLister::recursiveAddFiles(filenames, filesizes, Path::toNativeSeparators(*iter));
+            FileLister::recursiveAddFiles(filenames, filesizes, Path::toNativeSeparators(*iter), matcher);
+
+        // No files found. Walk the ignored directories too, to tell if all
+        // files are ignored or if there are no files.
+        if (filenames.empty() && !parser.GetIgnoredPaths().empty())
+        {
+            for (iter = pathnames.begin(); iter != pathnames.end(); ++iter)
+                FileLister::recursiveAddFiles(filenames, filesizes, Path::toNativeSeparators(*iter));
+        }
     }
 
     if (!filenames.empty())
     {
-        PathMatch matcher(parser.GetIgnoredPaths());
-        std::vector<std::string>::iterator iterBegin = filenames.begin();
-        for (int i = (int)filenames.size() - 1; i >= 0; i--)
+        std::vector<std::string>::iterator iterEnd = filenames.begin();
+        for (std::vector<std::string>::const_iterator i = filenames.begin(); i != filenames.end(); ++i)
         {
-            if (matcher.Match(filenames[(unsigned int)i]))
-                filenames.erase(iterBegin + i);
+            if (!matcher.Match(*i))
+                *iterEnd++ = *i;
         }
+        filenames.erase(iterEnd, filenames.end());
     }
     else
     {
@@ -140,12 +153,46 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
     if (cppCheck.settings().reportProgress)
         time1 = std::time(0);
 
+    if (!cppCheck.settings().progressFile.empty())
+    {
+        _progress.open(cppCheck.settings().progressFile.c_str());
+        _progressStart = std::time(0);
+    }
+
+    // Only one file is checked => run the checks of that file in parallel instead
+    if (cppCheck.settings()._jobs > 1 && _filenames.size() == 1 && ThreadExecutor::isEnabled())
+    {
+        cppCheck.settings()._checkJobs = cppCheck.settings()._jobs;
+        cppCheck.settings()._jobs = 1;
+    }
+
     _settings = cppCheck.settings();
+    _outputFormat = ErrorLogger::ErrorMessage::Template(_settings._outputFormat);
+
+    // The --debug and --showtime output is written straight to the output
+    // stream. The errors are written as they come so they are shown
+    // before the output that comes after them.
+    if (_settings.debug || _settings._showtime != SHOWTIME_NONE)
+        _reportLimit = 0;
     if (_settings._xml)
     {
         reportErr(ErrorLogger::ErrorMessage::getXMLHeader(_settings._xml_version));
     }
 
+    // Analysis data of an earlier run
+    if (!_settings.analysisFile.empty())
+    {
+        std::ifstream fin(_settings.analysisFile.c_str(), std::ios::in | std::ios::binary);
+        CppCheck::readAnalysisFile(fin);
+    }
+
+    // Results of an earlier run
+    if (!_settings.cacheFile.empty())
+    {
+        std::ifstream fin(_settings.cacheFile.c_str(), std::ios::in | std::ios::binary);
+        CppCheck::readResultsCache(fin, _settings);
+    }
+
     unsigned int returnValue = 0;
     if (_settings._jobs == 1)
     {
@@ -165,8 +212,7 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
             {
                 processedsize += _filesizes[_filenames[c]];
             }
-            if (!_settings._errorsOnly)
-                reportStatus(c + 1, _filenames.size(), processedsize, totalfilesize);
+            reportStatus(c + 1, _filenames.size(), processedsize, totalfilesize);
         }
     }
     else if (!ThreadExecutor::isEnabled())
@@ -181,6 +227,18 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
         returnValue = executor.check();
     }
 
+    if (!_settings.analysisFile.empty())
+    {
+        std::ofstream fout(_settings.analysisFile.c_str(), std::ios::out | std::ios::binary);
+        CppCheck::writeAnalysisFile(fout);
+    }
+
+    if (!_settings.cacheFile.empty())
+    {
+        std::ofstream fout(_settings.cacheFile.c_str(), std::ios::out | std::ios::binary);
+        CppCheck::writeResultsCache(fout, _settings);
+    }
+
     reportUnmatchedSuppressions(cppCheck.settings().nomsg.getUnmatchedGlobalSuppressions());
 
     if (_settings._xml)
@@ -188,6 +246,8 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
         reportErr(ErrorLogger::ErrorMessage::getXMLFooter(_settings._xml_version));
     }
 
+    flushReport();
+
     if (returnValue)
         return _settings._exitCode;
     else
@@ -196,17 +256,55 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
 
 void CppCheckExecutor::reportErr(const std::string &errmsg)
 {
-    std::cerr << errmsg << std::endl;
+    _report += errmsg;
+    _report += '\n';
+    if (_report.size() >= _reportLimit)
+        flushReport();
 }
 
 void CppCheckExecutor::reportOut(const std::string &outmsg)
 {
+    // Write the errors first so they are shown before the output that comes after them
+    flushReport();
     std::cout << outmsg << std::endl;
 }
 
+void CppCheckExecutor::flushReport()
+{
+    if (_report.empty())
+        return;
+    std::cerr.write(_report.data(), static_cast<std::streamsize>(_report.size()));
+    std::cerr.flush();
+    _report.clear();
+}
+
+void CppCheckExecutor::writeProgress(const std::string &fields)
+{
+    std::ostringstream elapsed;
+    elapsed << ",\"elapsed\":" << (std::time(0) - _progressStart);
+    _progress << '{' << fields << elapsed.str() << "}\n" << std::flush;
+}
+
 void CppCheckExecutor::reportProgress(const std::string &filename, const char stage[], const unsigned int value)
 {
-    (void)filename;
+    // The stage is reported many times while it is going on, it is
+    // written once for each value
+    if (_progress.is_open() &&
+        (value != _progressValue || _progressStage != stage || filename != _progressFile))
+    {
+        _progressFile = filename;
+        _progressStage = stage;
+        _progressValue = value;
+
+        std::string fields("\"type\":\"stage\",\"file\":");
+        writeJSONString(fields, filename);
+        fields += ",\"stage\":";
+        writeJSONString(fields, stage);
+        std::ostringstream oss;
+        oss << ",\"progress\":" << value;
+        fields += oss.str();
+        writeProgress(fields);
+    }
 
     if (!time1)
         return;
@@ -235,12 +333,39 @@ void CppCheckExecutor::reportProgress(const std::string &filename, const char st
 
 void CppCheckExecutor::reportStatus(unsigned int fileindex, unsigned int filecount, long sizedone, long sizetotal)
 {
-    if (filecount > 1)
+    // The errors of the file are shown when it has been checked, also with -q and -j
+    flushReport();
+
+    // A record is written when the percentage changes and for the last file
+    const long percent = sizetotal > 0 ? static_cast<long>(static_cast<double>(sizedone) / sizetotal * 100) : 0;
+    if (_progress.is_open() && (percent != _statusPercent || fileindex == filecount))
+    {
+        _statusPercent = percent;
+
+        // Throughput so far, the time left is estimated from the bytes
+        // that are left
+        const double elapsed = static_cast<double>(std::time(0) - _progressStart);
+        std::ostringstream fields;
+        fields << "\"type\":\"status\""
+               << ",\"files_checked\":" << fileindex
+               << ",\"files_total\":" << filecount
+               << ",\"bytes_checked\":" << sizedone
+               << ",\"bytes_total\":" << sizetotal;
+        if (elapsed > 0)
+        {
+            fields << ",\"files_per_second\":" << fileindex / elapsed
+                   << ",\"bytes_per_second\":" << sizedone / elapsed;
+        }
+        if (sizedone > 0)
+            fields << ",\"eta\":" << static_cast<long>(elapsed * (sizetotal - sizedone) / sizedone);
+        writeProgress(fields.str());
+    }
+
+    if (filecount > 1 && !_settings._errorsOnly)
     {
         std::ostringstream oss;
         oss << fileindex << "/" << filecount
-            << " files checked " <<
-            (sizetotal > 0 ? static_cast<long>(static_cast<double>(sizedone) / sizetotal*100) : 0)
+            << " files checked " << percent
             << "% done";
         std::cout << oss.str() << std::endl;
     }
@@ -252,12 +377,18 @@ void CppCheckExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
     {
         reportOut(msg.toXML(false, _settings._xml_version));
     }
-    else if (_settings._xml)
-    {
-        reportErr(msg.toXML(_settings._verbose, _settings._xml_version));
-    }
     else
     {
-        reportErr(msg.toString(_settings._verbose, _settings._outputFormat));
+        // The message is written straight to the end of the report
+        if (_settings._xml)
+            msg.writeXML(_report, _settings._verbose, _settings._xml_version);
+        else if (_settings._json)
+            msg.writeJSON(_report);
+        else
+            msg.writeString(_report, _settings._verbose, _outputFormat);
+        _report += '\n';
+
+        if (_report.size() >= _reportLimit)
+            flushReport();
     }
 }
@@ -22,6 +22,7 @@
 #include "errorlogger.h"
 #include "settings.h"
 #include <ctime>
+#include <fstream>
 #include <vector>
 
 class CppCheck;
@@ -80,7 +81,7 @@ public:
      * @param sizedone The sum of sizes of the files checked.
      * @param sizetotal The total sizes of the files.
      */
-    static void reportStatus(unsigned int fileindex, unsigned int filecount, long sizedone, long sizetotal);
+    virtual void reportStatus(unsigned int fileindex, unsigned int filecount, long sizedone, long sizetotal);
 
 protected:
 
@@ -90,6 +91,17 @@ protected:
      */
     virtual void reportErr(const std::string &errmsg);
 
+    /**
+     * Write the errors that have been reported so far to the error stream.
+     */
+    void flushReport();
+
+    /**
+     * Write a record to the --progress-file.
+     * @param fields the fields of the JSON object, without the braces
+     */
+    void writeProgress(const std::string &fields);
+
     /**
      * @brief Parse command line args and get settings and file lists
      * from there.
@@ -117,6 +129,45 @@ private:
      */
     bool errorlist;
 
+    /**
+     * Errors that have not been written to the error stream yet. They
+     * are written in large blocks.
+     */
+    std::string _report;
+
+    /**
+     * The errors are written when there is this much of them
+     */
+    std::string::size_type _reportLimit;
+
+    /**
+     * The --template that the errors are written with
+     */
+    ErrorLogger::ErrorMessage::Template _outputFormat;
+
+    /**
+     * The --progress-file
+     */
+    std::ofstream _progress;
+
+    /**
+     * When the checking was started, the throughput in the --progress-file
+     * is counted from this
+     */
+    std::time_t _progressStart;
+
+    /**
+     * The last stage record, the same stage is written once
+     */
+    std::string _progressFile;
+    std::string _progressStage;
+    unsigned int _progressValue;
+
+    /**
+     * The percentage of the last status record
+     */
+    long _statusPercent;
+
     /**
      * List of files to check.
      */
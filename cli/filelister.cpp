@@ -23,6 +23,7 @@
 #include <sstream>
 #include "filelister.h"
 #include "path.h"
+#include "pathmatch.h"
 
 // This wrapper exists because Sun's CC does not allow a static_cast
 // from extern "C" int(*)(int) to int(*)(int).
@@ -54,6 +55,12 @@ bool FileLister::acceptFile(const std::string &filename)
     return false;
 }
 
+void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, std::map<std::string, long> &filesizes, const std::string &path)
+{
+    const PathMatch ignored((std::vector<std::string>()));
+    recursiveAddFiles(filenames, filesizes, path, ignored);
+}
+
 
 #ifdef _WIN32
 
@@ -129,7 +136,7 @@ static HANDLE MyFindFirstFile(std::string path, LPWIN32_FIND_DATA findData)
 
 #endif // defined(UNICODE)
 
-void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, std::map<std::string, long> &filesizes, const std::string &path)
+void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, std::map<std::string, long> &filesizes, const std::string &path, const PathMatch &ignored)
 {
     // oss is the search string passed into FindFirst and FindNext.
     // bdir is the base directory which is used to form pathnames.
@@ -208,7 +215,8 @@ void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, std::map
         else
         {
             // Directory
-            FileLister::recursiveAddFiles(filenames, filesizes, fname.str());
+            if (!ignored.Match(Path::fromNativeSeparators(fname.str()) + "/"))
+                FileLister::recursiveAddFiles(filenames, filesizes, fname.str(), ignored);
         }
 #if defined(UNICODE)
         delete [] ansiFfd;
@@ -238,82 +246,114 @@ bool FileLister::isDirectory(const std::string &path)
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <glob.h>
-#include <unistd.h>
-#include <stdlib.h>
-#include <limits.h>
+#include <dirent.h>
 #include <sys/stat.h>
-
-void FileLister::recursiveAddFiles2(std::vector<std::string> &relative,
-                                    std::vector<std::string> &absolute,
-                                    std::map<std::string, long> &filesizes,
-                                    const std::string &path)
+#include <set>
+
+/** Device and inode of a file. Files that are reached through several paths have the same id. */
+typedef std::pair<dev_t, ino_t> FileId;
+
+static void addPath(std::vector<std::string> &filenames,
+                    std::map<std::string, long> &filesizes,
+                    std::set<FileId> &seen,
+                    const PathMatch &ignored,
+                    const std::string &filename,
+                    bool userGiven);
+
+static void addDirectory(std::vector<std::string> &filenames,
+                         std::map<std::string, long> &filesizes,
+                         std::set<FileId> &seen,
+                         const PathMatch &ignored,
+                         std::string dir)
 {
-    std::ostringstream oss;
-    oss << path;
-    if (path.length() > 0 && path[path.length()-1] == '/')
-        oss << "*";
+    while (!dir.empty() && dir[dir.length()-1] == '/')
+        dir.erase(dir.length() - 1);
+    dir += '/';
 
-    glob_t glob_results;
-    glob(oss.str().c_str(), GLOB_MARK, 0, &glob_results);
-    for (unsigned int i = 0; i < glob_results.gl_pathc; i++)
+    DIR *d = opendir(dir.c_str());
+    if (!d)
+        return;
+
+    std::vector<std::string> names;
+    while (const struct dirent *entry = readdir(d))
     {
-        const std::string filename = glob_results.gl_pathv[i];
-        if (filename == "." || filename == ".." || filename.length() == 0)
+        // Hidden files, "." and ".." are skipped, like glob does
+        if (entry->d_name[0] == '.')
             continue;
 
-        if (filename[filename.length()-1] != '/')
-        {
-            // File
-#ifdef PATH_MAX
-            char fname[PATH_MAX];
-            if (realpath(filename.c_str(), fname) == NULL)
-#else
-            char *fname;
-            if ((fname = realpath(filename.c_str(), NULL)) == NULL)
+#ifdef _DIRENT_HAVE_D_TYPE
+        // No need to stat regular files that are not source files
+        if (entry->d_type == DT_REG && !FileLister::acceptFile(entry->d_name))
+            continue;
 #endif
-            {
-                continue;
-            }
 
-            // Does absolute path exist? then bail out
-            if (std::find(absolute.begin(), absolute.end(), std::string(fname)) != absolute.end())
-            {
-#ifndef PATH_MAX
-                free(fname);
-#endif
-                continue;
-            }
+        names.push_back(entry->d_name);
+    }
+    closedir(d);
 
-            if (Path::sameFileName(path,filename) || FileLister::acceptFile(filename))
-            {
-                relative.push_back(filename);
-                absolute.push_back(fname);
-                struct stat sb;
-                if (stat(fname, &sb) == 0)
-                {
-                    // Limitation: file sizes are assumed to fit in a 'long'
-                    filesizes[filename] = static_cast<long>(sb.st_size);
-                }
-            }
+    // Files are listed in the same order as glob sorts them
+    std::sort(names.begin(), names.end());
 
-#ifndef PATH_MAX
-            free(fname);
-#endif
-        }
-        else
-        {
-            // Directory
-            recursiveAddFiles2(relative, absolute, filesizes, filename);
-        }
-    }
-    globfree(&glob_results);
+    for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+        addPath(filenames, filesizes, seen, ignored, dir + *it, false);
 }
 
+static void addPath(std::vector<std::string> &filenames,
+                    std::map<std::string, long> &filesizes,
+                    std::set<FileId> &seen,
+                    const PathMatch &ignored,
+                    const std::string &filename,
+                    bool userGiven)
+{
+    struct stat sb;
+    if (stat(filename.c_str(), &sb) != 0)
+        return;
 
-void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, std::map<std::string, long> &filesizes, const std::string &path)
+    if (S_ISDIR(sb.st_mode))
+    {
+        // Don't walk ignored directories
+        if (ignored.Match(filename + "/"))
+            return;
+
+        // A directory that has been walked already (symlink loops..)
+        if (seen.insert(FileId(sb.st_dev, sb.st_ino)).second)
+            addDirectory(filenames, filesizes, seen, ignored, filename);
+    }
+
+    // If recursive is not used, accept all files given by user
+    else if (userGiven || FileLister::acceptFile(filename))
+    {
+        // Same file already added through another path? then bail out
+        if (!seen.insert(FileId(sb.st_dev, sb.st_ino)).second)
+            return;
+
+        filenames.push_back(filename);
+        // Limitation: file sizes are assumed to fit in a 'long'
+        filesizes[filename] = static_cast<long>(sb.st_size);
+    }
+}
+
+void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, std::map<std::string, long> &filesizes, const std::string &path, const PathMatch &ignored)
 {
-    std::vector<std::string> abs;
-    recursiveAddFiles2(filenames, abs, filesizes, path);
+    std::set<FileId> seen;
+
+    // The given path may contain wildcards
+    glob_t glob_results;
+    glob(path.c_str(), GLOB_MARK, 0, &glob_results);
+    for (unsigned int i = 0; i < glob_results.gl_pathc; i++)
+    {
+        const std::string filename = glob_results.gl_pathv[i];
+        if (filename.empty())
+            continue;
+
+        // The given directories are walked even if they are ignored, the
+        // files are filtered out later
+        if (filename[filename.length()-1] == '/')
+            addDirectory(filenames, filesizes, seen, ignored, filename);
+        else
+            addPath(filenames, filesizes, seen, ignored, filename, Path::sameFileName(path, filename));
+    }
+    globfree(&glob_results);
 }
 
 bool FileLister::isDirectory(const std::string &path)
@@ -23,6 +23,8 @@
 #include <string>
 #include <map>
 
+class PathMatch;
+
 /// @addtogroup CLI
 /// @{
 
@@ -43,6 +45,20 @@ public:
                                   std::map<std::string, long> &filesizes,
                                   const std::string &path);
 
+    /**
+     * @brief Recursively add source files to a vector.
+     * Same as above, but subdirectories that match the ignored paths
+     * are not walked.
+     * @param filenames output vector that filenames are written to
+     * @param filesizes output map that contains the size of each file
+     * @param path root path
+     * @param ignored ignored paths
+     */
+    static void recursiveAddFiles(std::vector<std::string> &filenames,
+                                  std::map<std::string, long> &filesizes,
+                                  const std::string &path,
+                                  const PathMatch &ignored);
+
     /**
      * @brief Check if the file extension indicates that it's a source file.
      * Check if the file has source file extension: *.c;*.cpp;*.cxx;*.c++;*.cc;*.txx
@@ -56,13 +72,6 @@ public:
      * @return returns true if the path is a directory
      */
     static bool isDirectory(const std::string &path);
-
-#ifndef _WIN32
-    static void recursiveAddFiles2(std::vector<std::string> &relative,
-                                   std::vector<std::string> &absolute,
-                                   std::map<std::string, long> &filesizes,
-                                   const std::string &path);
-#endif
 };
 
 /// @}
@@ -18,56 +18,82 @@
 
 #include "pathmatch.h"
 
-PathMatch::PathMatch(const std::vector<std::string> &masks)
-    : _masks(masks)
+template <class It>
+void PathMatch::insert(std::vector<Node> &trie, It begin, It end)
 {
+    unsigned int node = 0;
+    for (It it = begin; it != end; ++it)
+    {
+        std::map<char, unsigned int>::const_iterator child = trie[node].next.find(*it);
+        if (child != trie[node].next.end())
+        {
+            node = child->second;
+        }
+        else
+        {
+            trie.push_back(Node());
+            trie[node].next[*it] = static_cast<unsigned int>(trie.size() - 1);
+            node = static_cast<unsigned int>(trie.size() - 1);
+        }
+    }
+    trie[node].mask = true;
 }
 
-bool PathMatch::Match(const std::string &path)
+template <class It>
+bool PathMatch::matchStart(const std::vector<Node> &trie, It begin, It end)
 {
-    if (path.empty())
-        return false;
+    unsigned int node = 0;
+    for (It it = begin; it != end; ++it)
+    {
+        std::map<char, unsigned int>::const_iterator child = trie[node].next.find(*it);
+        if (child == trie[node].next.end())
+            return false;
+        node = child->second;
+        if (trie[node].mask)
+            return true;
+    }
+    return false;
+}
 
+PathMatch::PathMatch(const std::vector<std::string> &masks)
+    : _dirMasks(1), _fileMasks(1)
+{
     std::vector<std::string>::const_iterator iterMask;
-    for (iterMask = _masks.begin(); iterMask != _masks.end(); ++iterMask)
+    for (iterMask = masks.begin(); iterMask != masks.end(); ++iterMask)
     {
-        // Filtering directory name
-        if ((*iterMask)[(*iterMask).length() - 1] == '/')
-        {
-            std::string findpath(path);
-            if (findpath[findpath.length() - 1] != '/')
-                findpath = RemoveFilename(findpath);
+        if (iterMask->empty())
+            continue;
 
-            if ((*iterMask).length() > findpath.length())
-                continue;
-            // Match relative paths starting with mask
-            // -isrc matches src/foo.cpp
-            if (findpath.compare(0, (*iterMask).size(), *iterMask) == 0)
-                return true;
-            // Match only full directory name in middle or end of the path
-            // -isrc matches myproject/src/ but does not match
-            // myproject/srcfiles/ or myproject/mysrc/
-            if (findpath.find("/" + *iterMask) != std::string::npos)
-                return true;
-        }
-        // Filtering filename
+        if ((*iterMask)[iterMask->length() - 1] == '/')
+            insert(_dirMasks, iterMask->begin(), iterMask->end());
         else
-        {
-            if ((*iterMask).length() > path.length())
-                continue;
-            // Check if path ends with mask
-            // -ifoo.cpp matches (./)foo.c, src/foo.cpp and proj/src/foo.cpp
-            // -isrc/file.cpp matches src/foo.cpp and proj/src/foo.cpp
-            if (path.compare(path.size() - (*iterMask).size(), path.size(), *iterMask) == 0)
-                return true;
-
-        }
+            insert(_fileMasks, iterMask->rbegin(), iterMask->rend());
     }
-    return false;
 }
 
-std::string PathMatch::RemoveFilename(const std::string &path)
+bool PathMatch::Match(const std::string &path) const
 {
-    const size_t ind = path.find_last_of('/');
-    return path.substr(0, ind + 1);
+    if (path.empty())
+        return false;
+
+    // Filtering directory name
+    // The directory part of the path is matched against the directory masks.
+    const std::string::size_type dirEnd = (path[path.length() - 1] == '/') ? path.length() : path.find_last_of('/') + 1;
+    for (std::string::size_type pos = 0; pos < dirEnd; ++pos)
+    {
+        // Match relative paths starting with mask
+        // -isrc matches src/foo.cpp
+        // Match only full directory name in middle or end of the path
+        // -isrc matches myproject/src/ but does not match
+        // myproject/srcfiles/ or myproject/mysrc/
+        if ((pos == 0 || path[pos - 1] == '/') &&
+            matchStart(_dirMasks, path.begin() + pos, path.begin() + dirEnd))
+            return true;
+    }
+
+    // Filtering filename
+    // Check if path ends with mask
+    // -ifoo.cpp matches (./)foo.c, src/foo.cpp and proj/src/foo.cpp
+    // -isrc/file.cpp matches src/foo.cpp and proj/src/foo.cpp
+    return matchStart(_fileMasks, path.rbegin(), path.rend());
 }
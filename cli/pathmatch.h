@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 /// @addtogroup CLI
 /// @{
@@ -43,19 +44,38 @@ public:
      * @param path Path to match.
      * @return true if any of the masks match the path, false otherwise.
      */
-    bool Match(const std::string &path);
-
-protected:
+    bool Match(const std::string &path) const;
 
+private:
     /**
-     * @brief Remove filename part from the path.
-     * @param path Path to edit.
-     * @return path without filename part.
+     * The masks are compiled into tries so a path is matched against
+     * all masks in one pass.
      */
-    std::string RemoveFilename(const std::string &path);
+    struct Node
+    {
+        Node() : mask(false)
+        { }
 
-private:
-    std::vector<std::string> _masks;
+        /** child node for each next character */
+        std::map<char, unsigned int> next;
+
+        /** does a mask end at this node? */
+        bool mask;
+    };
+
+    /** Add string to the trie */
+    template <class It>
+    static void insert(std::vector<Node> &trie, It begin, It end);
+
+    /** Does a string in the trie match the start of the given range? */
+    template <class It>
+    static bool matchStart(const std::vector<Node> &trie, It begin, It end);
+
+    /** Directory masks (-isrc/) */
+    std::vector<Node> _dirMasks;
+
+    /** File masks (-isrc/foo.cpp), reversed */
+    std::vector<Node> _fileMasks;
 };
 
 /// @}
@@ -16,13 +16,15 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "cppcheckexecutor.h"
 #include "threadexecutor.h"
 #include "cppcheck.h"
 #include <iostream>
+#include <fstream>
 #include <algorithm>
+#include <set>
 #ifdef THREADING_MODEL_FORK
 #include <sys/wait.h>
+#include <poll.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <cstdlib>
@@ -30,6 +32,7 @@
 #include <cstdio>
 #include <errno.h>
 #include <time.h>
+#include <sys/time.h>
 #endif
 
 ThreadExecutor::ThreadExecutor(const std::vector<std::string> &filenames, const std::map<std::string, long> &filesizes, Settings &settings, ErrorLogger &errorLogger)
@@ -37,6 +40,8 @@ ThreadExecutor::ThreadExecutor(const std::vector<std::string> &filenames, const
 {
 #ifdef THREADING_MODEL_FORK
     _wpipe = 0;
+    _analysing = false;
+    _lastProgressValue = 0;
 #endif
 }
 
@@ -50,38 +55,190 @@ void ThreadExecutor::addFileContent(const std::string &path, const std::string &
     _fileContents[ path ] = content;
 }
 
+std::vector<std::string> ThreadExecutor::scheduleFiles(const std::vector<std::string> &filenames, const std::map<std::string, long> &filesizes, const std::map<std::string, unsigned long> &times)
+{
+    // Time per byte in the files that have been checked before
+    double knownTime = 0.0;
+    double knownSize = 0.0;
+    for (std::vector<std::string>::const_iterator f = filenames.begin(); f != filenames.end(); ++f)
+    {
+        std::map<std::string, unsigned long>::const_iterator t = times.find(*f);
+        std::map<std::string, long>::const_iterator s = filesizes.find(*f);
+        if (t != times.end() && s != filesizes.end() && s->second > 0)
+        {
+            knownTime += t->second;
+            knownSize += s->second;
+        }
+    }
+    const double timePerByte = (knownSize > 0.0) ? (knownTime / knownSize) : 1.0;
+
+    // Sort by descending cost. Files with the same cost keep their order.
+    std::vector<std::pair<double, unsigned int> > costs;
+    for (unsigned int i = 0; i < filenames.size(); ++i)
+    {
+        double cost = 0.0;
+        std::map<std::string, unsigned long>::const_iterator t = times.find(filenames[i]);
+        std::map<std::string, long>::const_iterator s = filesizes.find(filenames[i]);
+        if (t != times.end())
+            cost = t->second;
+        else if (s != filesizes.end())
+            cost = s->second * timePerByte;
+        costs.push_back(std::make_pair(-cost, i));
+    }
+    std::sort(costs.begin(), costs.end());
+
+    std::vector<std::string> result;
+    for (std::vector<std::pair<double, unsigned int> >::const_iterator c = costs.begin(); c != costs.end(); ++c)
+        result.push_back(filenames[c->second]);
+    return result;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ////// This code is for platforms that support fork() only ////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef THREADING_MODEL_FORK
 
+// Error messages are sent from the children in a binary format. The
+// fields are written one after another. Numbers are written as they are
+// in memory and strings are prefixed with their length. The file names
+// in the call stack are sent once in a message of their own, after that
+// they are referred to by index.
+
+static void writeUInt(std::string &data, unsigned int value)
+{
+    data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void writeString(std::string &data, const std::string &str)
+{
+    writeUInt(data, static_cast<unsigned int>(str.length()));
+    data.append(str);
+}
+
+static bool readUInt(const char *&pos, const char *end, unsigned int &value)
+{
+    if (static_cast<std::size_t>(end - pos) < sizeof(value))
+        return false;
+    std::memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+static bool readString(const char *&pos, const char *end, std::string &str)
+{
+    unsigned int len = 0;
+    if (!readUInt(pos, end, len) || static_cast<std::size_t>(end - pos) < len)
+        return false;
+    str.assign(pos, len);
+    pos += len;
+    return true;
+}
+
+bool ThreadExecutor::readErrorMessage(const char *pos, const char *end, const std::vector<std::string> &fileNames, ErrorLogger::ErrorMessage &msg)
+{
+    unsigned int severity = 0, inconclusive = 0, stackSize = 0;
+    std::string shortMessage, verboseMessage;
+    if (!readString(pos, end, msg._id) ||
+        !readUInt(pos, end, severity) ||
+        !readUInt(pos, end, inconclusive) ||
+        !readString(pos, end, shortMessage) ||
+        !readString(pos, end, verboseMessage) ||
+        !readUInt(pos, end, stackSize))
+        return false;
+
+    msg._severity = static_cast<Severity::SeverityType>(severity);
+    msg._inconclusive = bool(inconclusive != 0);
+    if (verboseMessage == shortMessage)
+        msg.setmsg(shortMessage);
+    else
+        msg.setmsg(shortMessage + "\n" + verboseMessage);
+
+    for (unsigned int i = 0; i < stackSize; ++i)
+    {
+        unsigned int file = 0, line = 0;
+        if (!readUInt(pos, end, file) || !readUInt(pos, end, line) || file >= fileNames.size())
+            return false;
+        msg._callStack.push_back(ErrorLogger::ErrorMessage::FileLocation(fileNames[file], line));
+    }
+
+    return true;
+}
+
 int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
 {
-    char type = 0;
-    if (read(rpipe, &type, 1) <= 0)
+    // Read as much as there is in the pipe. The messages are handled when
+    // they have been read completely.
+    char data[65536];
+    const ssize_t count = read(rpipe, data, sizeof(data));
+    if (count <= 0)
     {
-        if (errno == EAGAIN)
+        if (count < 0 && errno == EAGAIN)
             return 0;
 
+        _pipeBuffers.erase(rpipe);
         return -1;
     }
 
-    if (type != '1' && type != '2' && type != '3')
+    std::string &buffer = _pipeBuffers[rpipe];
+    buffer.append(data, static_cast<std::string::size_type>(count));
+
+    std::string::size_type pos = 0;
+    unsigned int len = 0;
+    while (buffer.size() - pos >= 1 + sizeof(len))
     {
-        std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
-        exit(0);
+        const char type = buffer[pos];
+        std::memcpy(&len, buffer.data() + pos + 1, sizeof(len));
+        if (buffer.size() - pos - 1 - sizeof(len) < len)
+            break;
+
+        const bool more = handleMessage(rpipe, type, buffer.data() + pos + 1 + sizeof(len), len, result);
+        pos += 1 + sizeof(len) + len;
+        if (!more)
+        {
+            _pipeBuffers.erase(rpipe);
+            return -1;
+        }
     }
+    buffer.erase(0, pos);
 
-    unsigned int len = 0;
-    if (read(rpipe, &len, sizeof(len)) <= 0)
+    return 1;
+}
+
+// The check times are saved in the --cost-file, one file per line:
+// the time in milliseconds and the file name.
+
+static void readFileTimes(const std::string &costFile, std::map<std::string, unsigned long> &times)
+{
+    std::ifstream fin(costFile.c_str());
+    unsigned long ms = 0;
+    while (fin >> ms)
     {
-        std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
-        exit(0);
+        fin.get();
+        std::string name;
+        if (!std::getline(fin, name))
+            break;
+        times[name] = ms;
     }
+}
+
+static void writeFileTimes(const std::string &costFile, const std::map<std::string, unsigned long> &times)
+{
+    std::ofstream fout(costFile.c_str());
+    for (std::map<std::string, unsigned long>::const_iterator t = times.begin(); t != times.end(); ++t)
+        fout << t->second << ' ' << t->first << '\n';
+}
 
-    char *buf = new char[len];
-    if (read(rpipe, buf, len) <= 0)
+static unsigned long elapsedMilliseconds(const struct timeval &start)
+{
+    struct timeval now;
+    gettimeofday(&now, 0);
+    return static_cast<unsigned long>((now.tv_sec - start.tv_sec) * 1000L + (now.tv_usec - start.tv_usec) / 1000L);
+}
+
+bool ThreadExecutor::handleMessage(int rpipe, char type, const char *buf, unsigned int len, unsigned int &result)
+{
+    if (type != '1' && type != '2' && type != '3' && type != '4' && type != '5' && type != '6' && type != '7' && type != '8')
     {
         std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
         exit(0);
@@ -94,7 +251,11 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
     else if (type == '2')
     {
         ErrorLogger::ErrorMessage msg;
-        msg.deserialize(buf);
+        if (!readErrorMessage(buf, buf + len, _pipeFileNames[rpipe], msg))
+        {
+            std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
+            exit(0);
+        }
 
         std::string file;
         unsigned int line(0);
@@ -108,30 +269,108 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
         {
             // Alert only about unique errors
             std::string errmsg = msg.toString(_settings._verbose);
-            if (std::find(_errorList.begin(), _errorList.end(), errmsg) == _errorList.end())
+            if (_errorList.insert(errmsg).second)
             {
-                _errorList.push_back(errmsg);
                 _errorLogger.reportErr(msg);
             }
         }
     }
+    else if (type == '5')
+    {
+        // File name used in the following error messages
+        _pipeFileNames[rpipe].push_back(buf);
+    }
+    else if (type == '6')
+    {
+        // Progress of the file that the child checks
+        const char *pos = buf;
+        std::string filename, stage;
+        unsigned int value = 0;
+        if (!readString(pos, buf + len, filename) || !readString(pos, buf + len, stage) || !readUInt(pos, buf + len, value))
+        {
+            std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
+            exit(0);
+        }
+        _errorLogger.reportProgress(filename, stage.c_str(), value);
+    }
+    else if (type == '4')
+    {
+        // Analysis data of the file for the analysis file
+        const char *pos = buf;
+        std::string filename, data;
+        if (!readString(pos, buf + len, filename) || !readString(pos, buf + len, data))
+        {
+            std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
+            exit(0);
+        }
+        CppCheck::setFileAnalysisData(filename, data);
+
+        // The children that check the files get the data of all files
+        if (_analysing)
+            CppCheck::saveFileAnalysisData(data);
+    }
+    else if (type == '7')
+    {
+        // Results of the file for the results cache
+        const char *pos = buf;
+        std::string filename, data;
+        if (!readString(pos, buf + len, filename) || !readString(pos, buf + len, data))
+        {
+            std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
+            exit(0);
+        }
+        CppCheck::setCachedResults(filename, data);
+    }
+    else if (type == '8')
+    {
+        // The results of the file were reported from the results cache
+        _cachedPipes.insert(rpipe);
+    }
     else if (type == '3')
     {
         std::istringstream iss(buf);
         unsigned int fileResult = 0;
         iss >> fileResult;
         result += fileResult;
-        delete [] buf;
-        return -1;
+        return false;
     }
 
-    delete [] buf;
-    return 1;
+    return true;
 }
 
 unsigned int ThreadExecutor::check()
 {
     _fileCount = 0;
+
+    // Start the files that take the longest time first
+    std::map<std::string, unsigned long> times;
+    if (!_settings.costFile.empty())
+        readFileTimes(_settings.costFile, times);
+
+    // Analyse all files before the checking starts so each file is checked
+    // with the analysis data of all files. The data that is still valid in
+    // the --analysis-file is not collected again.
+    std::vector<std::string> analyse;
+    for (unsigned int f = 0; f < _filenames.size(); ++f)
+    {
+        std::string data;
+        if (_settings.analysisFile.empty() || !CppCheck::getFileAnalysisData(_filenames[f], data))
+            analyse.push_back(_filenames[f]);
+    }
+    _analysing = true;
+    runChildren(scheduleFiles(analyse, _filesizes, times), times);
+    _analysing = false;
+
+    const unsigned int result = runChildren(scheduleFiles(_filenames, _filesizes, times), times);
+
+    if (!_settings.costFile.empty())
+        writeFileTimes(_settings.costFile, times);
+
+    return result;
+}
+
+unsigned int ThreadExecutor::runChildren(const std::vector<std::string> &filenames, std::map<std::string, unsigned long> &times)
+{
     unsigned int result = 0;
 
     long totalfilesize = 0;
@@ -143,12 +382,13 @@ unsigned int ThreadExecutor::check()
     std::list<int> rpipes;
     std::map<pid_t, std::string> childFile;
     std::map<int, std::string> pipeFile;
+    std::map<int, struct timeval> pipeStart;
     long processedsize = 0;
     unsigned int i = 0;
     while (true)
     {
         // Start a new child
-        if (i < _filenames.size() && rpipes.size() < _settings._jobs)
+        if (i < filenames.size() && rpipes.size() < _settings._jobs)
         {
             int pipes[2];
             if (pipe(pipes) == -1)
@@ -170,6 +410,9 @@ unsigned int ThreadExecutor::check()
                 exit(1);
             }
 
+            // Output that is not flushed would be written by the child too
+            std::fflush(stdout);
+
             pid_t pid = fork();
             if (pid < 0)
             {
@@ -181,20 +424,52 @@ unsigned int ThreadExecutor::check()
             {
                 close(pipes[0]);
                 _wpipe = pipes[1];
+                _pipeBuffer.clear();
+                _lastProgressFile.clear();
+                _lastProgressStage.clear();
+                _lastProgressValue = 0;
+                _fileIndexes.clear();
+
+                if (_analysing)
+                {
+                    analyseFile(filenames[i]);
+                    writeToPipe('3', "0");
+                    exit(0);
+                }
 
                 CppCheck fileChecker(*this, false);
                 fileChecker.settings(_settings);
                 unsigned int resultOfCheck = 0;
 
-                if (_fileContents.size() > 0 && _fileContents.find(_filenames[i]) != _fileContents.end())
+                if (_fileContents.size() > 0 && _fileContents.find(filenames[i]) != _fileContents.end())
                 {
                     // File content was given as a string
-                    resultOfCheck = fileChecker.check(_filenames[i], _fileContents[ _filenames[i] ]);
+                    resultOfCheck = fileChecker.check(filenames[i], _fileContents[ filenames[i] ]);
                 }
                 else
                 {
                     // Read file from a file
-                    resultOfCheck = fileChecker.check(_filenames[i]);
+                    resultOfCheck = fileChecker.check(filenames[i]);
+                }
+
+                // Send the results of the file to the parent
+                std::string results;
+                if (!_settings.cacheFile.empty() && CppCheck::getCachedResults(filenames[i], results))
+                {
+                    std::string record;
+                    writeString(record, filenames[i]);
+                    writeString(record, results);
+                    writeToPipe('7', record);
+                }
+                if (fileChecker.resultsFromCache())
+                    writeToPipe('8', "");
+                std::string analysisData;
+                if (!_settings.analysisFile.empty() && CppCheck::getFileAnalysisData(filenames[i], analysisData))
+                {
+                    std::string record;
+                    writeString(record, filenames[i]);
+                    writeString(record, analysisData);
+                    writeToPipe('4', record);
                 }
 
                 std::ostringstream oss;
@@ -205,36 +480,55 @@ unsigned int ThreadExecutor::check()
 
             close(pipes[1]);
             rpipes.push_back(pipes[0]);
-            childFile[pid] = _filenames[i];
-            pipeFile[pipes[0]] = _filenames[i];
+            childFile[pid] = filenames[i];
+            pipeFile[pipes[0]] = filenames[i];
+            gettimeofday(&pipeStart[pipes[0]], 0);
 
             ++i;
         }
         else if (!rpipes.empty())
         {
-            fd_set rfds;
-            FD_ZERO(&rfds);
+            std::vector<struct pollfd> fds;
             for (std::list<int>::const_iterator rp = rpipes.begin(); rp != rpipes.end(); ++rp)
-                FD_SET(*rp, &rfds);
+            {
+                struct pollfd fd;
+                fd.fd = *rp;
+                fd.events = POLLIN;
+                fd.revents = 0;
+                fds.push_back(fd);
+            }
 
-            int r = select(*std::max_element(rpipes.begin(), rpipes.end()) + 1, &rfds, NULL, NULL, NULL);
+            int r = poll(&fds[0], static_cast<nfds_t>(fds.size()), -1);
 
             if (r > 0)
             {
+                std::vector<struct pollfd>::const_iterator fd = fds.begin();
                 std::list<int>::iterator rp = rpipes.begin();
                 while (rp != rpipes.end())
                 {
-                    if (FD_ISSET(*rp, &rfds))
+                    if (fd->revents != 0)
                     {
                         int readRes = handleRead(*rp, result);
-                        if (readRes == -1)
+                        if (readRes == -1 && _analysing)
+                        {
+                            _pipeFileNames.erase(*rp);
+                            close(*rp);
+                            rp = rpipes.erase(rp);
+                        }
+                        else if (readRes == -1)
                         {
                             long size = 0;
+                            const bool cached = _cachedPipes.erase(*rp) != 0;
                             std::map<int, std::string>::iterator p = pipeFile.find(*rp);
                             if (p != pipeFile.end())
                             {
                                 std::string name = p->second;
                                 pipeFile.erase(p);
+                                // The time of a file that was not checked
+                                // tells nothing, the earlier time is kept
+                                if (!cached)
+                                    times[name] = elapsedMilliseconds(pipeStart[*rp]);
+                                pipeStart.erase(*rp);
                                 std::map<std::string, long>::const_iterator fs = _filesizes.find(name);
                                 if (fs != _filesizes.end())
                                 {
@@ -244,9 +538,9 @@ unsigned int ThreadExecutor::check()
 
                             _fileCount++;
                             processedsize += size;
-                            if (!_settings._errorsOnly)
-                                CppCheckExecutor::reportStatus(_fileCount, _filenames.size(), processedsize, totalfilesize);
+                            _errorLogger.reportStatus(_fileCount, _filenames.size(), processedsize, totalfilesize);
 
+                            _pipeFileNames.erase(*rp);
                             close(*rp);
                             rp = rpipes.erase(rp);
                         }
@@ -255,6 +549,7 @@ unsigned int ThreadExecutor::check()
                     }
                     else
                         ++rp;
+                    ++fd;
                 }
             }
 
@@ -270,7 +565,8 @@ unsigned int ThreadExecutor::check()
                     childFile.erase(c);
                 }
 
-                if (WIFSIGNALED(stat))
+                // A crash is reported when the file is checked
+                if (WIFSIGNALED(stat) && !_analysing)
                 {
                     std::ostringstream oss;
                     oss << "Internal error: Child process crashed with signal " << WTERMSIG(stat);
@@ -293,26 +589,78 @@ unsigned int ThreadExecutor::check()
         }
     }
 
-
     return result;
 }
 
+/** Error logger that drops the messages */
+class SilentErrorLogger : public ErrorLogger
+{
+public:
+    void reportOut(const std::string &)
+    { }
+
+    void reportErr(const ErrorLogger::ErrorMessage &)
+    { }
+};
+
+void ThreadExecutor::analyseFile(const std::string &filename)
+{
+    // The errors are reported when the file is checked
+    SilentErrorLogger silent;
+    CppCheck analyser(silent, false);
+    analyser.settings(_settings);
+
+    std::map<std::string, std::string>::const_iterator content = _fileContents.find(filename);
+    if (content != _fileContents.end())
+    {
+        std::istringstream istr(content->second);
+        analyser.analyseFile(istr, filename);
+    }
+    else
+    {
+        std::ifstream fin(filename.c_str());
+        analyser.analyseFile(fin, filename);
+    }
+
+    std::string data;
+    if (CppCheck::getFileAnalysisData(filename, data))
+    {
+        std::string record;
+        writeString(record, filename);
+        writeString(record, data);
+        writeToPipe('4', record);
+    }
+}
+
 void ThreadExecutor::writeToPipe(char type, const std::string &data)
 {
     unsigned int len = data.length() + 1;
-    char *out = new char[ len + 1 + sizeof(len)];
-    out[0] = type;
-    std::memcpy(&(out[1]), &len, sizeof(len));
-    std::memcpy(&(out[1+sizeof(len)]), data.c_str(), len);
-    if (write(_wpipe, out, len + 1 + sizeof(len)) <= 0)
+    _pipeBuffer += type;
+    _pipeBuffer.append(reinterpret_cast<const char *>(&len), sizeof(len));
+    _pipeBuffer.append(data.c_str(), len);
+
+    // The messages are sent in batches. Text output, progress and the
+    // result are sent right away so the progress is seen.
+    if (type == '1' || type == '3' || type == '6' || _pipeBuffer.size() >= 65536)
+        flushPipe();
+}
+
+void ThreadExecutor::flushPipe()
+{
+    std::string::size_type pos = 0;
+    while (pos < _pipeBuffer.size())
     {
-        delete [] out;
-        out = 0;
-        std::cerr << "#### ThreadExecutor::writeToPipe, Failed to write to pipe" << std::endl;
-        exit(0);
+        const ssize_t count = write(_wpipe, _pipeBuffer.data() + pos, _pipeBuffer.size() - pos);
+        if (count <= 0)
+        {
+            if (count < 0 && errno == EINTR)
+                continue;
+            std::cerr << "#### ThreadExecutor::writeToPipe, Failed to write to pipe" << std::endl;
+            exit(0);
+        }
+        pos += static_cast<std::string::size_type>(count);
     }
-
-    delete [] out;
+    _pipeBuffer.clear();
 }
 
 void ThreadExecutor::reportOut(const std::string &outmsg)
@@ -322,7 +670,48 @@ void ThreadExecutor::reportOut(const std::string &outmsg)
 
 void ThreadExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
-    writeToPipe('2', msg.serialize());
+    std::string data;
+    writeString(data, msg._id);
+    writeUInt(data, static_cast<unsigned int>(msg._severity));
+    writeUInt(data, msg._inconclusive ? 1U : 0U);
+    writeString(data, msg.shortMessage());
+    writeString(data, msg.verboseMessage());
+    writeUInt(data, static_cast<unsigned int>(msg._callStack.size()));
+
+    for (std::list<ErrorLogger::ErrorMessage::FileLocation>::const_iterator loc = msg._callStack.begin(); loc != msg._callStack.end(); ++loc)
+    {
+        const std::string file(loc->getfile(false));
+        std::map<std::string, unsigned int>::const_iterator index = _fileIndexes.find(file);
+        if (index == _fileIndexes.end())
+        {
+            // Send the file name before the first message that uses it
+            writeToPipe('5', file);
+            index = _fileIndexes.insert(std::make_pair(file, static_cast<unsigned int>(_fileIndexes.size()))).first;
+        }
+        writeUInt(data, index->second);
+        writeUInt(data, loc->line);
+    }
+
+    writeToPipe('2', data);
+}
+
+void ThreadExecutor::reportProgress(const std::string &filename, const char stage[], const unsigned int value)
+{
+    if (!_settings.reportProgress && _settings.progressFile.empty())
+        return;
+
+    // The same progress is reported many times, it is sent once
+    if (value == _lastProgressValue && _lastProgressStage == stage && filename == _lastProgressFile)
+        return;
+    _lastProgressFile = filename;
+    _lastProgressStage = stage;
+    _lastProgressValue = value;
+
+    std::string data;
+    writeString(data, filename);
+    writeString(data, stage);
+    writeUInt(data, value);
+    writeToPipe('6', data);
 }
 
 #else
@@ -340,4 +729,9 @@ void ThreadExecutor::reportErr(const ErrorLogger::ErrorMessage &/*msg*/)
 
 }
 
+void ThreadExecutor::reportProgress(const std::string &/*filename*/, const char /*stage*/[], const unsigned int /*value*/)
+{
+
+}
+
 #endif
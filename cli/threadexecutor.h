@@ -22,6 +22,8 @@
 #include <vector>
 #include <string>
 #include <list>
+#include <map>
+#include <set>
 #include "settings.h"
 #include "errorlogger.h"
 
@@ -44,6 +46,7 @@ public:
     unsigned int check();
     virtual void reportOut(const std::string &outmsg);
     virtual void reportErr(const ErrorLogger::ErrorMessage &msg);
+    virtual void reportProgress(const std::string &filename, const char stage[], const unsigned int value);
 
     /**
      * @brief Add content to a file, to be used in unit testing.
@@ -54,6 +57,20 @@ public:
      */
     void addFileContent(const std::string &path, const std::string &content);
 
+    /**
+     * @brief Get the order in which the files are checked.
+     *
+     * The files that take the longest time are started first, so the
+     * run does not end with one big file being checked alone. The time
+     * of a file that was not checked before is estimated from its size.
+     *
+     * @param filenames files to check
+     * @param filesizes size of each file
+     * @param times check time of the files in earlier runs, in milliseconds
+     * @return the files in the order they are checked
+     */
+    static std::vector<std::string> scheduleFiles(const std::vector<std::string> &filenames, const std::map<std::string, long> &filesizes, const std::map<std::string, unsigned long> &times);
+
 private:
     const std::vector<std::string> &_filenames;
     const std::map<std::string, long> &_filesizes;
@@ -73,13 +90,70 @@ private:
      *         1 if we did read something
      */
     int handleRead(int rpipe, unsigned int &result);
+
+    /**
+     * Check or analyse the files in child processes
+     * @param filenames the files in the order they are started
+     * @param times the check time of each file, updated when the files
+     * are checked
+     * @return the results of the checks
+     */
+    unsigned int runChildren(const std::vector<std::string> &filenames, std::map<std::string, unsigned long> &times);
+
+    /** Analyse a file in a child process and send its analysis data to the parent */
+    void analyseFile(const std::string &filename);
+
+    /**
+     * Handle a message from a child.
+     * @return false if the child is done
+     */
+    bool handleMessage(int rpipe, char type, const char *buf, unsigned int len, unsigned int &result);
+
+    /** Add message to the pipe buffer. The buffer is written when it is big enough. */
     void writeToPipe(char type, const std::string &data);
+
+    /** Write the pipe buffer to the pipe */
+    void flushPipe();
+
+    /**
+     * Decode an error message that a child has sent.
+     * @param pos start of the message data
+     * @param end end of the message data
+     * @param fileNames file names that the child has sent so far
+     * @param msg the decoded message
+     * @return false if the data is not valid
+     */
+    static bool readErrorMessage(const char *pos, const char *end, const std::vector<std::string> &fileNames, ErrorLogger::ErrorMessage &msg);
+
     /**
      * Write end of status pipe, different for each child.
      * Not used in master process.
      */
     int _wpipe;
-    std::list<std::string> _errorList;
+
+    /** Messages that the child has not written to the pipe yet */
+    std::string _pipeBuffer;
+
+    /** The progress that the child has sent last */
+    std::string _lastProgressFile;
+    std::string _lastProgressStage;
+    unsigned int _lastProgressValue;
+
+    /** Data that has been read from each pipe but not handled yet */
+    std::map<int, std::string> _pipeBuffers;
+    std::set<std::string> _errorList;
+
+    /** Index of each file name that the child has sent to the parent */
+    std::map<std::string, unsigned int> _fileIndexes;
+
+    /** File names that each child has sent, the key is the read pipe */
+    std::map<int, std::vector<std::string> > _pipeFileNames;
+
+    /** The children whose file results came from the results cache, the key is the read pipe */
+    std::set<int> _cachedPipes;
+
+    /** Are the children analysing the files instead of checking them? */
+    bool _analysing;
 public:
     /**
      * @return true if support for threads exist.
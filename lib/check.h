@@ -43,7 +43,7 @@ public:
 
     /** This constructor is used when running checks. */
     Check(const std::string &aname, const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
-        : _name(aname), _tokenizer(tokenizer), _settings(settings), _errorLogger(errorLogger)
+        : _name(aname), _tokenizer(tokenizer), _settings(settings), _errorLogger(errorLogger), _redirectedErrorLogger(0)
     { }
 
     virtual ~Check()
@@ -82,6 +82,17 @@ public:
         (void)data;
     }
 
+    /**
+     * Get the analysis data that has been saved so far. The data can be
+     * given to saveAnalysisData in another process or in a later run.
+     * @param data container where the data is stored
+     */
+    virtual void getAnalysisData(std::set<std::string> &data) const
+    {
+        // suppress compiler warnings
+        (void)data;
+    }
+
     /** run checks, the token list is not simplified */
     virtual void runChecks(const Tokenizer *, const Settings *, ErrorLogger *)
     { }
@@ -101,6 +112,22 @@ public:
     /** get information about this class, used to generate documentation */
     virtual std::string classInfo() const = 0;
 
+    /**
+     * Report the errors to another error logger. The child processes of
+     * checkExecutionPaths send the errors to the parent process this way.
+     * @param errorLogger the error logger, 0 => the error logger of the check
+     */
+    void redirectErrors(ErrorLogger *errorLogger)
+    {
+        _redirectedErrorLogger = errorLogger;
+    }
+
+    /** the error logger that the errors are reported to */
+    ErrorLogger *errorLogger() const
+    {
+        return _redirectedErrorLogger ? _redirectedErrorLogger : _errorLogger;
+    }
+
     /**
      * Write given error to errorlogger or to out stream in xml format.
      * This is for for printout out the error list with --errorlist
@@ -152,6 +179,9 @@ private:
     /** disabled assignment operator */
     void operator=(const Check &);
 
+    /** errors are reported here instead of _errorLogger if this is set */
+    ErrorLogger *_redirectedErrorLogger;
+
     /** report an error */
     void reportError(const std::list<const Token *> &callstack, Severity::SeverityType severity, const std::string &id, std::string msg, bool inconclusive)
     {
@@ -171,8 +201,8 @@ private:
         ErrorLogger::ErrorMessage errmsg(locationList, severity, msg, id, inconclusive);
         if (_tokenizer && _tokenizer->getFiles() && !_tokenizer->getFiles()->empty())
             errmsg.file0 = _tokenizer->getFiles()->at(0);
-        if (_errorLogger)
-            _errorLogger->reportErr(errmsg);
+        if (errorLogger())
+            errorLogger()->reportErr(errmsg);
         else
             reportError(errmsg);
     }
@@ -192,7 +222,7 @@ template <> struct less<Check *>
 }
 
 inline Check::Check(const std::string &aname)
-    : _name(aname), _tokenizer(0), _settings(0), _errorLogger(0)
+    : _name(aname), _tokenizer(0), _settings(0), _errorLogger(0), _redirectedErrorLogger(0)
 {
     instances().push_back(this);
     instances().sort(std::less<Check *>());
@@ -29,6 +29,8 @@
 #include <algorithm>
 #include <sstream>
 #include <list>
+#include <map>
+#include <set>
 #include <cstring>
 #include <cctype>
 #include <climits>
@@ -544,46 +546,138 @@ void CheckBufferOverrun::parse_for_body(const Token *tok2, const ArrayInfo &arra
 
 
 
-void CheckBufferOverrun::checkFunctionParameter(const Token &tok, unsigned int par, const ArrayInfo &arrayInfo)
+/**
+ * Which parameter in a function call takes the total size of the array?
+ * \param funcname name of the called function
+ * \param par on what parameter is the array used
+ * \return the index of the size parameter. 1001 => parameter 2 * parameter 3.
+ *         0 => the function is not known.
+ */
+static unsigned int sizeArgument(const std::string &funcname, unsigned int par)
 {
-    // total_size : which parameter in function call takes the total size?
-    std::map<std::string, unsigned int> total_size;
-
-    total_size["fgets"] = 2;	// The second argument for fgets can't exceed the total size of the array
-    total_size["memcmp"] = 3;
-    total_size["memcpy"] = 3;
-    total_size["memmove"] = 3;
-
-    if (par == 1)
+    // The tables are only built once
+    static std::map<std::string, unsigned int> total_size;
+    static std::map<std::string, unsigned int> total_size1;
+    static std::map<std::string, unsigned int> total_size2;
+    if (total_size.empty())
     {
+        total_size["fgets"] = 2;	// The second argument for fgets can't exceed the total size of the array
+        total_size["memcmp"] = 3;
+        total_size["memcpy"] = 3;
+        total_size["memmove"] = 3;
+
         // reading from array
         // if it is zero terminated properly there won't be buffer overruns
-        total_size["strncat"] = 3;
-        total_size["strncpy"] = 3;
-        total_size["memset"] = 3;
-        total_size["fread"] = 1001;     // parameter 2 * parameter 3
-        total_size["fwrite"] = 1001;    // parameter 2 * parameter 3
+        total_size1 = total_size;
+        total_size1["strncat"] = 3;
+        total_size1["strncpy"] = 3;
+        total_size1["memset"] = 3;
+        total_size1["fread"] = 1001;     // parameter 2 * parameter 3
+        total_size1["fwrite"] = 1001;    // parameter 2 * parameter 3
+
+        total_size2 = total_size;
+        total_size2["read"] = 3;
+        total_size2["pread"] = 3;
+        total_size2["write"] = 3;
+        total_size2["recv"] = 3;
+        total_size2["recvfrom"] = 3;
+        total_size2["send"] = 3;
+        total_size2["sendto"] = 3;
+    }
+
+    const std::map<std::string, unsigned int> &sizes = (par == 1) ? total_size1 : ((par == 2) ? total_size2 : total_size);
+    std::map<std::string, unsigned int>::const_iterator it = sizes.find(funcname);
+    return (it == sizes.end()) ? 0 : it->second;
+}
+
+
+const std::vector<const Token *> &CheckBufferOverrun::parameterIndexes(const Token *ftok, unsigned int par)
+{
+    const std::pair<const Token *, unsigned int> key(ftok, par);
+    std::map<std::pair<const Token *, unsigned int>, std::vector<const Token *> >::const_iterator cached = _parameterIndexes.find(key);
+    if (cached != _parameterIndexes.end())
+        return cached->second;
+
+    std::vector<const Token *> &indexes = _parameterIndexes[key];
+
+    // Get varid for the corresponding parameter..
+    unsigned int parameter = 1;
+    unsigned int parameterVarId = 0;
+    for (const Token *ftok2 = ftok->tokAt(2); ftok2; ftok2 = ftok2->next())
+    {
+        if (ftok2->str() == ",")
+        {
+            if (parameter >= par)
+                break;
+            ++parameter;
+        }
+        else if (ftok2->str() == ")")
+            break;
+        else if (parameter == par && Token::Match(ftok2, "%var% ,|)"))
+            parameterVarId = ftok2->varId();
     }
 
-    if (par == 2)
+    // No parameterVarId => bail out
+    if (parameterVarId == 0)
+        return indexes;
+
+    // Step into the function scope..
+    ftok = ftok->next()->link();
+    if (!Token::Match(ftok, ") const| {"))
+        return indexes;
+    ftok = Token::findmatch(ftok, "{");
+    ftok = ftok->next();
+
+    // Check the parameter usage in the function scope..
+    for (; ftok; ftok = ftok->next())
     {
-        total_size["read"] = 3;
-        total_size["pread"] = 3;
-        total_size["write"] = 3;
-        total_size["recv"] = 3;
-        total_size["recvfrom"] = 3;
-        total_size["send"] = 3;
-        total_size["sendto"] = 3;
+        if (Token::Match(ftok, "if|for|while ("))
+        {
+            // bailout if there is buffer usage..
+            if (bailoutIfSwitch(ftok, parameterVarId))
+            {
+                break;
+            }
+
+            // no bailout is needed. skip the if-block
+            else
+            {
+                // goto end of if block..
+                ftok = ftok->next()->link()->next()->link();
+                if (Token::simpleMatch(ftok, "} else {"))
+                    ftok = ftok->tokAt(2)->link();
+                continue;
+            }
+        }
+
+        if (ftok->str() == "}")
+            break;
+
+        if (ftok->varId() == parameterVarId)
+        {
+            if (Token::Match(ftok->previous(), "-- %var%") ||
+                Token::Match(ftok, "%var% --"))
+                break;
+
+            if (Token::Match(ftok->previous(), "=|;|{|}|%op% %var% [ %num% ]"))
+                indexes.push_back(ftok);
+        }
     }
 
-    std::map<std::string, unsigned int>::const_iterator it = total_size.find(tok.str());
-    if (it != total_size.end())
+    return indexes;
+}
+
+
+void CheckBufferOverrun::checkFunctionParameter(const Token &tok, unsigned int par, const ArrayInfo &arrayInfo)
+{
+    const unsigned int sizeArg = sizeArgument(tok.str(), par);
+    if (sizeArg > 0)
     {
         if (arrayInfo.element_size == 0)
             return;
 
         // arg : the index of the "wanted" argument in the function call.
-        unsigned int arg = it->second;
+        unsigned int arg = sizeArg;
 
         // Parse function call. When a ',' is seen, arg is decremented.
         // if arg becomes 1 then the current function parameter is the wanted parameter.
@@ -648,80 +742,21 @@ void CheckBufferOverrun::checkFunctionParameter(const Token &tok, unsigned int p
         const Token *ftok = _tokenizer->getFunctionTokenByName(tok.str().c_str());
         if (Token::Match(ftok, "%var% (") && Token::Match(ftok->next()->link(), ") const| {"))
         {
-            // Get varid for the corresponding parameter..
-            unsigned int parameter = 1;
-            unsigned int parameterVarId = 0;
-            for (const Token *ftok2 = ftok->tokAt(2); ftok2; ftok2 = ftok2->next())
-            {
-                if (ftok2->str() == ",")
-                {
-                    if (parameter >= par)
-                        break;
-                    ++parameter;
-                }
-                else if (ftok2->str() == ")")
-                    break;
-                else if (parameter == par && Token::Match(ftok2, "%var% ,|)"))
-                    parameterVarId = ftok2->varId();
-            }
-
-            // No parameterVarId => bail out
-            if (parameterVarId == 0)
-                return;
-
-            // Step into the function scope..
-            ftok = ftok->next()->link();
-            if (!Token::Match(ftok, ") const| {"))
-                return;
-            ftok = Token::findmatch(ftok, "{");
-            ftok = ftok->next();
-
-            // Check the parameter usage in the function scope..
-            for (; ftok; ftok = ftok->next())
+            // Check the array indexes that the function uses with the parameter
+            const std::vector<const Token *> &indexTokens = parameterIndexes(ftok, par);
+            for (std::vector<const Token *>::const_iterator it = indexTokens.begin(); it != indexTokens.end(); ++it)
             {
-                if (Token::Match(ftok, "if|for|while ("))
+                const MathLib::bigint index = MathLib::toLongNumber((*it)->strAt(2));
+                if (index >= 0 && arrayInfo.num[0] > 0 && index >= arrayInfo.num[0])
                 {
-                    // bailout if there is buffer usage..
-                    if (bailoutIfSwitch(ftok, parameterVarId))
-                    {
-                        break;
-                    }
-
-                    // no bailout is needed. skip the if-block
-                    else
-                    {
-                        // goto end of if block..
-                        ftok = ftok->next()->link()->next()->link();
-                        if (Token::simpleMatch(ftok, "} else {"))
-                            ftok = ftok->tokAt(2)->link();
-                        continue;
-                    }
-                }
-
-                if (ftok->str() == "}")
-                    break;
+                    std::list<const Token *> callstack;
+                    callstack.push_back(&tok);
+                    callstack.push_back(*it);
 
-                if (ftok->varId() == parameterVarId)
-                {
-                    if (Token::Match(ftok->previous(), "-- %var%") ||
-                        Token::Match(ftok, "%var% --"))
-                        break;
+                    std::vector<MathLib::bigint> indexes;
+                    indexes.push_back(index);
 
-                    if (Token::Match(ftok->previous(), "=|;|{|}|%op% %var% [ %num% ]"))
-                    {
-                        const MathLib::bigint index = MathLib::toLongNumber(ftok->strAt(2));
-                        if (index >= 0 && arrayInfo.num[0] > 0 && index >= arrayInfo.num[0])
-                        {
-                            std::list<const Token *> callstack;
-                            callstack.push_back(&tok);
-                            callstack.push_back(ftok);
-
-                            std::vector<MathLib::bigint> indexes;
-                            indexes.push_back(index);
-
-                            arrayIndexOutOfBounds(callstack, arrayInfo, indexes);
-                        }
-                    }
+                    arrayIndexOutOfBounds(callstack, arrayInfo, indexes);
                 }
             }
         }
@@ -766,61 +801,105 @@ void CheckBufferOverrun::checkFunctionCall(const Token *tok, const ArrayInfo &ar
 }
 
 
-void CheckBufferOverrun::checkScopeForBody(const Token *tok, const ArrayInfo &arrayInfo, bool &bailout)
+/** Information about a for loop. It is the same for all arrays. */
+struct ForLoop
+{
+    /** variable id of the loop counter */
+    unsigned int counter_varid;
+
+    /** min and max value of the loop counter */
+    std::string min_counter_value;
+    std::string max_counter_value;
+
+    /** the array index that is always out of bounds if the condition is */
+    std::string strindex;
+
+    /** max value of the loop counter given in the condition */
+    MathLib::bigint condition_max;
+
+    /** is the counter assigned in the third statement? */
+    bool assign_step;
+
+    /** the first token in the loop body */
+    const Token *body;
+
+    /** the loop can't be handled. stop checking the array */
+    bool bailout;
+};
+
+/**
+ * Parse the for loop
+ * \param tok the "for" token
+ * \param loop the loop information
+ * \return false if the loop body is not checked
+ */
+static bool for_loop(const Token *tok, ForLoop &loop)
 {
-    bailout = false;
+    loop.bailout = false;
     const Token *tok2 = tok->tokAt(2);
-    const MathLib::bigint size = arrayInfo.num[0];
 
     // Check if there is a break in the body..
     {
         const Token *bodyStart = tok->next()->link()->next();
         const Token *bodyEnd = bodyStart->link();
         if (Token::findmatch(bodyStart, "break ;", bodyEnd))
-            return;
+            return false;
     }
 
-    unsigned int counter_varid = 0;
-    std::string min_counter_value;
-    std::string max_counter_value;
-
-    tok2 = for_init(tok2, counter_varid, min_counter_value);
-    if (tok2 == 0 || counter_varid == 0)
-        return;
+    loop.counter_varid = 0;
+    tok2 = for_init(tok2, loop.counter_varid, loop.min_counter_value);
+    if (tok2 == 0 || loop.counter_varid == 0)
+        return false;
 
     bool maxMinFlipped = false;
-    std::string strindex;
-    if (!for_condition(tok2, counter_varid, min_counter_value, max_counter_value, strindex, maxMinFlipped))
-        return;
+    if (!for_condition(tok2, loop.counter_varid, loop.min_counter_value, loop.max_counter_value, loop.strindex, maxMinFlipped))
+        return false;
 
-    // Get index variable and stopsize.
-    bool condition_out_of_bounds = bool(size > 0);
-    if (MathLib::toLongNumber(max_counter_value) < size)
-        condition_out_of_bounds = false;
+    loop.condition_max = MathLib::toLongNumber(loop.max_counter_value);
 
-    if (!for3(tok2->tokAt(4), counter_varid, min_counter_value, max_counter_value, maxMinFlipped))
-        return;
+    if (!for3(tok2->tokAt(4), loop.counter_varid, loop.min_counter_value, loop.max_counter_value, maxMinFlipped))
+        return false;
 
-    if (Token::Match(tok2->tokAt(4), "%var% =|+=|-=") && MathLib::toLongNumber(max_counter_value) <= size)
-        condition_out_of_bounds = false;
+    loop.assign_step = Token::Match(tok2->tokAt(4), "%var% =|+=|-=");
 
     // Goto the end parenthesis of the for-statement: "for (x; y; z)" ..
     tok2 = tok->next()->link();
     if (!tok2 || !tok2->tokAt(5))
     {
-        bailout = true;
-        return;
+        loop.bailout = true;
+        return false;
     }
 
     // Check is the counter variable increased elsewhere inside the loop or used
     // for anything else except reading
-    if (for_bailout(tok2->next(), counter_varid))
+    if (for_bailout(tok2->next(), loop.counter_varid))
     {
-        bailout = true;
-        return;
+        loop.bailout = true;
+        return false;
     }
 
-    parse_for_body(tok2->next(), arrayInfo, strindex, condition_out_of_bounds, counter_varid, min_counter_value, max_counter_value);
+    loop.body = tok2->next();
+    return true;
+}
+
+void CheckBufferOverrun::checkScopeForBody(const Token *tok, const ArrayInfo &arrayInfo, bool &bailout)
+{
+    ForLoop loop;
+    const bool parsed = for_loop(tok, loop);
+    bailout = loop.bailout;
+    if (!parsed)
+        return;
+
+    // Get index variable and stopsize.
+    const MathLib::bigint size = arrayInfo.num[0];
+    bool condition_out_of_bounds = bool(size > 0);
+    if (loop.condition_max < size)
+        condition_out_of_bounds = false;
+
+    if (loop.assign_step && MathLib::toLongNumber(loop.max_counter_value) <= size)
+        condition_out_of_bounds = false;
+
+    parse_for_body(loop.body, arrayInfo, loop.strindex, condition_out_of_bounds, loop.counter_varid, loop.min_counter_value, loop.max_counter_value);
 }
 
 
@@ -1025,8 +1104,6 @@ void CheckBufferOverrun::checkScope(const Token *tok, const std::vector<std::str
 
 void CheckBufferOverrun::checkScope(const Token *tok, const ArrayInfo &arrayInfo)
 {
-    const MathLib::bigint total_size = arrayInfo.num[0] * arrayInfo.element_size;
-
     // Count { and } for tok
     unsigned int indentlevel = 0;
     for (; tok; tok = tok->next())
@@ -1043,181 +1120,373 @@ void CheckBufferOverrun::checkScope(const Token *tok, const ArrayInfo &arrayInfo
             --indentlevel;
         }
 
-        else if (Token::Match(tok, "%varid% [ %num% ]", arrayInfo.varid))
+        else if (!checkScopeToken(tok, arrayInfo))
+            break;
+    }
+}
+
+
+void CheckBufferOverrun::checkScope(const std::vector<const Token *> &uses, const ArrayInfo &arrayInfo)
+{
+    for (std::vector<const Token *>::const_iterator it = uses.begin(); it != uses.end(); ++it)
+    {
+        if ((*it)->str() != "{" && (*it)->str() != "}" && !checkScopeToken(*it, arrayInfo))
+            break;
+    }
+}
+
+
+bool CheckBufferOverrun::checkScopeToken(const Token *tok, const ArrayInfo &arrayInfo)
+{
+    const MathLib::bigint total_size = arrayInfo.num[0] * arrayInfo.element_size;
+
+    if (Token::Match(tok, "%varid% [ %num% ]", arrayInfo.varid))
+
+    {
+        std::vector<MathLib::bigint> indexes;
+        for (const Token *tok2 = tok->next(); Token::Match(tok2, "[ %num% ]"); tok2 = tok2->tokAt(3))
         {
-            std::vector<MathLib::bigint> indexes;
-            for (const Token *tok2 = tok->next(); Token::Match(tok2, "[ %num% ]"); tok2 = tok2->tokAt(3))
+            const MathLib::bigint index = MathLib::toLongNumber(tok2->strAt(1));
+            if (index < 0)
             {
-                const MathLib::bigint index = MathLib::toLongNumber(tok2->strAt(1));
-                if (index < 0)
-                {
-                    indexes.clear();
-                    break;
-                }
-                indexes.push_back(index);
+                indexes.clear();
+                break;
             }
-            if (indexes.size() == arrayInfo.num.size())
-            {
-                // Check if the indexes point outside the whole array..
-                // char a[10][10];
-                // a[0][20]  <-- ok.
-                // a[9][20]  <-- error.
+            indexes.push_back(index);
+        }
+        if (indexes.size() == arrayInfo.num.size())
+        {
+            // Check if the indexes point outside the whole array..
+            // char a[10][10];
+            // a[0][20]  <-- ok.
+            // a[9][20]  <-- error.
 
-                // total number of elements of array..
-                MathLib::bigint totalElements = 1;
+            // total number of elements of array..
+            MathLib::bigint totalElements = 1;
 
-                // total index..
-                MathLib::bigint totalIndex = 0;
+            // total index..
+            MathLib::bigint totalIndex = 0;
 
-                // calculate the totalElements and totalIndex..
-                for (unsigned int i = 0; i < indexes.size(); ++i)
-                {
-                    std::size_t ri = indexes.size() - 1 - i;
-                    totalIndex += indexes[ri] * totalElements;
-                    totalElements *= arrayInfo.num[ri];
-                }
+            // calculate the totalElements and totalIndex..
+            for (unsigned int i = 0; i < indexes.size(); ++i)
+            {
+                std::size_t ri = indexes.size() - 1 - i;
+                totalIndex += indexes[ri] * totalElements;
+                totalElements *= arrayInfo.num[ri];
+            }
 
-                // just taking the address?
-                const bool addr(Token::Match(tok->previous(), "[.&]") ||
-                                Token::simpleMatch(tok->tokAt(-2), "& ("));
+            // just taking the address?
+            const bool addr(Token::Match(tok->previous(), "[.&]") ||
+                            Token::simpleMatch(tok->tokAt(-2), "& ("));
 
-                // Is totalIndex in bounds?
-                if (totalIndex > totalElements || (!addr && totalIndex == totalElements))
-                {
-                    arrayIndexOutOfBounds(tok, arrayInfo, indexes);
-                }
+            // Is totalIndex in bounds?
+            if (totalIndex > totalElements || (!addr && totalIndex == totalElements))
+            {
+                arrayIndexOutOfBounds(tok, arrayInfo, indexes);
             }
-
         }
 
-        // Loop..
-        else if (Token::simpleMatch(tok, "for ("))
-        {
-            bool bailout = false;
-            checkScopeForBody(tok, arrayInfo, bailout);
-            if (bailout)
-                break;
-            continue;
-        }
+    }
 
+    // Loop..
+    else if (Token::simpleMatch(tok, "for ("))
+    {
+        bool bailout = false;
+        checkScopeForBody(tok, arrayInfo, bailout);
+        return !bailout;
+    }
 
-        // Check function call..
-        if (Token::Match(tok, "%var% ("))
-        {
-            checkFunctionCall(tok, arrayInfo);
-        }
 
-        if (_settings->_checkCodingStyle)
+    // Check function call..
+    if (Token::Match(tok, "%var% ("))
+    {
+        checkFunctionCall(tok, arrayInfo);
+    }
+
+    if (_settings->_checkCodingStyle)
+    {
+        // check for strncpy which is not terminated
+        if ((Token::Match(tok, "strncpy ( %varid% , %var% , %num% )", arrayInfo.varid)))
         {
-            // check for strncpy which is not terminated
-            if ((Token::Match(tok, "strncpy ( %varid% , %var% , %num% )", arrayInfo.varid)))
+            // strncpy takes entire variable length as input size
+            if ((unsigned int)MathLib::toLongNumber(tok->strAt(6)) >= total_size)
             {
-                // strncpy takes entire variable length as input size
-                if ((unsigned int)MathLib::toLongNumber(tok->strAt(6)) >= total_size)
+                const Token *tok2 = tok->next()->link()->next();
+                for (; tok2; tok2 = tok2->next())
                 {
-                    const Token *tok2 = tok->next()->link()->next();
-                    for (; tok2; tok2 = tok2->next())
+                    if (tok2->varId() == tok->tokAt(2)->varId())
                     {
-                        if (tok2->varId() == tok->tokAt(2)->varId())
+                        if (!Token::Match(tok2, "%varid% [ %any% ]  = 0 ;", tok->tokAt(2)->varId()))
                         {
-                            if (!Token::Match(tok2, "%varid% [ %any% ]  = 0 ;", tok->tokAt(2)->varId()))
-                            {
-                                // this is currently 'experimental'. See TestBufferOverrun::terminateStrncpy3
-                                if (_settings->experimental)
-                                    terminateStrncpyError(tok);
-                            }
-
-                            break;
+                            // this is currently 'experimental'. See TestBufferOverrun::terminateStrncpy3
+                            if (_settings->experimental)
+                                terminateStrncpyError(tok);
                         }
+
+                        break;
                     }
                 }
             }
         }
+    }
+
+    // Dangerous usage of strncat..
+    if (Token::Match(tok, "strncpy|strncat ( %varid% , %any% , %num% )", arrayInfo.varid))
+    {
+        if (tok->str() == "strncat")
+        {
+            const MathLib::bigint n = MathLib::toLongNumber(tok->strAt(6));
+            if (n >= total_size)
+                strncatUsage(tok);
+        }
 
-        // Dangerous usage of strncat..
-        if (Token::Match(tok, "strncpy|strncat ( %varid% , %any% , %num% )", arrayInfo.varid))
+        // Dangerous usage of strncpy + strncat..
+        if (Token::Match(tok->tokAt(8), "; strncat ( %varid% , %any% , %num% )", arrayInfo.varid))
         {
-            if (tok->str() == "strncat")
-            {
-                const MathLib::bigint n = MathLib::toLongNumber(tok->strAt(6));
-                if (n >= total_size)
-                    strncatUsage(tok);
-            }
+            const MathLib::bigint n = MathLib::toLongNumber(tok->strAt(6)) + MathLib::toLongNumber(tok->strAt(15));
+            if (n > total_size)
+                strncatUsage(tok->tokAt(9));
+        }
+    }
+
+    // Writing data into array..
+    if (Token::Match(tok, "strcpy|strcat ( %varid% , %str% )", arrayInfo.varid))
+    {
+        const std::size_t len = Token::getStrLength(tok->tokAt(4));
+        if (total_size > 0 && len >= (unsigned int)total_size)
+        {
+            bufferOverrun(tok, arrayInfo.varname);
+            return true;
+        }
+    }
+
+    // Detect few strcat() calls
+    if (total_size > 0 && Token::Match(tok, "strcat ( %varid% , %str% ) ;", arrayInfo.varid))
+    {
+        std::size_t charactersAppend = 0;
+        const Token *tok2 = tok;
 
-            // Dangerous usage of strncpy + strncat..
-            if (Token::Match(tok->tokAt(8), "; strncat ( %varid% , %any% , %num% )", arrayInfo.varid))
+        while (tok2 && Token::Match(tok2, "strcat ( %varid% , %str% ) ;", arrayInfo.varid))
+        {
+            charactersAppend += Token::getStrLength(tok2->tokAt(4));
+            if (charactersAppend >= (unsigned int)total_size)
             {
-                const MathLib::bigint n = MathLib::toLongNumber(tok->strAt(6)) + MathLib::toLongNumber(tok->strAt(15));
-                if (n > total_size)
-                    strncatUsage(tok->tokAt(9));
+                bufferOverrun(tok2, arrayInfo.varname);
+                break;
             }
+            tok2 = tok2->tokAt(7);
         }
+    }
 
-        // Writing data into array..
-        if (Token::Match(tok, "strcpy|strcat ( %varid% , %str% )", arrayInfo.varid))
+
+    if (Token::Match(tok, "sprintf ( %varid% , %str% [,)]", arrayInfo.varid))
+    {
+        checkSprintfCall(tok, total_size);
+    }
+
+    // snprintf..
+    if (total_size > 0 && Token::Match(tok, "snprintf ( %varid% , %num% ,", arrayInfo.varid))
+    {
+        const MathLib::bigint n = MathLib::toLongNumber(tok->strAt(4));
+        if (n > total_size)
+            outOfBounds(tok->tokAt(4), "snprintf size");
+    }
+
+    // undefined behaviour: result of pointer arithmetic is out of bounds
+    if (_settings->_checkCodingStyle && Token::Match(tok, "= %varid% + %num% ;", arrayInfo.varid))
+    {
+        const MathLib::bigint index = MathLib::toLongNumber(tok->strAt(3));
+        if (index < 0 || index > arrayInfo.num[0])
         {
-            const std::size_t len = Token::getStrLength(tok->tokAt(4));
-            if (total_size > 0 && len >= (unsigned int)total_size)
+            pointerOutOfBounds(tok->next(), "array");
+        }
+    }
+
+    return true;
+}
+
+
+//---------------------------------------------------------------------------
+// Checking local variables in a scope
+//---------------------------------------------------------------------------
+
+/**
+ * @brief The positions of the variables and loops in the token list. It is
+ * collected in one sweep so each array declaration doesn't need to rescan
+ * the rest of its scope.
+ */
+class ArrayUses
+{
+public:
+    explicit ArrayUses(const Token *tokens)
+    {
+        const unsigned int npos = ~0U;
+
+        // the "{" that are open and the for loop they belong to
+        std::vector<std::pair<unsigned int, unsigned int> > open;
+
+        for (const Token *tok = tokens; tok; tok = tok->next())
+        {
+            const unsigned int pos = static_cast<unsigned int>(_tokens.size());
+            _tokens.push_back(tok);
+            _enclosing.push_back(open.empty() ? npos : open.back().first);
+            _end.push_back(npos);
+
+            if (tok->varId() > 0)
+                _varUses[tok->varId()].push_back(pos);
+
+            if (Token::simpleMatch(tok, "for ("))
             {
-                bufferOverrun(tok, arrayInfo.varname);
-                continue;
+                _forLoops.push_back(pos);
+                _forBodyEnd.push_back(npos);
+                _forBailout.push_back(0);
+            }
+
+            if (tok->str() == "{")
+            {
+                unsigned int loop = npos;
+                if (Token::simpleMatch(tok->previous(), ")") &&
+                    tok->previous()->link() &&
+                    Token::simpleMatch(tok->previous()->link()->previous(), "for (") &&
+                    !_forLoops.empty() &&
+                    _tokens[_forLoops.back()] == tok->previous()->link()->previous())
+                    loop = static_cast<unsigned int>(_forLoops.size() - 1);
+                open.push_back(std::make_pair(pos, loop));
+            }
+            else if (tok->str() == "}" && !open.empty())
+            {
+                _end[open.back().first] = pos;
+                if (open.back().second != npos)
+                    _forBodyEnd[open.back().second] = pos;
+                open.pop_back();
             }
         }
+    }
 
-        // Detect few strcat() calls
-        if (total_size > 0 && Token::Match(tok, "strcat ( %varid% , %str% ) ;", arrayInfo.varid))
+    const Token *token(unsigned int pos) const
+    {
+        return _tokens[pos];
+    }
+
+    /**
+     * The tokens after the given position where checkScope might find
+     * something for the array. That is the tokens where a pattern with
+     * the array variable starts, the function calls where it is a
+     * parameter and the loops that use it or that stop the checking.
+     * @param varid variable id of the array
+     * @param start position of the token where the checking starts
+     * @return the tokens, in order
+     */
+    std::vector<const Token *> uses(unsigned int varid, unsigned int start)
+    {
+        const unsigned int npos = ~0U;
+
+        // the checking stops at the end of the scope
+        unsigned int end = (_enclosing[start] == npos || _end[_enclosing[start]] == npos) ?
+                                 static_cast<unsigned int>(_tokens.size()) : _end[_enclosing[start]];
+
+        std::set<unsigned int> positions;
+
+        const std::vector<unsigned int> &varUses = _varUses[varid];
+        std::vector<unsigned int>::const_iterator first = std::upper_bound(varUses.begin(), varUses.end(), start);
+        for (std::vector<unsigned int>::const_iterator it = first; it != varUses.end() && *it < end; ++it)
         {
-            std::size_t charactersAppend = 0;
-            const Token *tok2 = tok;
+            // patterns can start two tokens before the variable
+            for (unsigned int pos = std::max(start + 1, *it >= 2 ? *it - 2 : 0); pos <= *it; ++pos)
+                positions.insert(pos);
 
-            while (tok2 && Token::Match(tok2, "strcat ( %varid% , %str% ) ;", arrayInfo.varid))
+            // parameter in a function call => the function name
+            if (*it >= 1 && _tokens[*it - 1]->str() == ",")
             {
-                charactersAppend += Token::getStrLength(tok2->tokAt(4));
-                if (charactersAppend >= (unsigned int)total_size)
+                unsigned int level = 0;
+                for (unsigned int pos = *it - 1; pos > start + 1; --pos)
                 {
-                    bufferOverrun(tok2, arrayInfo.varname);
-                    break;
+                    const std::string &str = _tokens[pos]->str();
+                    if (str == ")")
+                        ++level;
+                    else if (str == "(" && level > 0)
+                        --level;
+                    else if (str == "(")
+                    {
+                        positions.insert(pos - 1);
+                        break;
+                    }
+                    else if (str == ";" || str == "{" || str == "}")
+                        break;
                 }
-                tok2 = tok2->tokAt(7);
             }
         }
 
-
-        if (Token::Match(tok, "sprintf ( %varid% , %str% [,)]", arrayInfo.varid))
+        // loops that use the variable in the body or that stop the checking
+        std::vector<unsigned int>::const_iterator loop = std::upper_bound(_forLoops.begin(), _forLoops.end(), start);
+        for (; loop != _forLoops.end() && *loop < end; ++loop)
         {
-            checkSprintfCall(tok, total_size);
-        }
+            const unsigned int i = static_cast<unsigned int>(loop - _forLoops.begin());
+            const unsigned int bodyEnd = _forBodyEnd[i];
+            if (bodyEnd == npos)
+            {
+                positions.insert(*loop);
+                continue;
+            }
 
-        // snprintf..
-        if (total_size > 0 && Token::Match(tok, "snprintf ( %varid% , %num% ,", arrayInfo.varid))
-        {
-            const MathLib::bigint n = MathLib::toLongNumber(tok->strAt(4));
-            if (n > total_size)
-                outOfBounds(tok->tokAt(4), "snprintf size");
+            std::vector<unsigned int>::const_iterator use = std::upper_bound(first, varUses.end(), *loop);
+            if ((use != varUses.end() && *use < bodyEnd) || bailout(i))
+                positions.insert(*loop);
+
+            // the loop bails out => there is nothing more to check
+            if (bailout(i))
+                end = *loop + 1;
         }
 
-        // undefined behaviour: result of pointer arithmetic is out of bounds
-        if (_settings->_checkCodingStyle && Token::Match(tok, "= %varid% + %num% ;", arrayInfo.varid))
+        std::vector<const Token *> result;
+        for (std::set<unsigned int>::const_iterator it = positions.begin(); it != positions.end() && *it < end; ++it)
+            result.push_back(_tokens[*it]);
+        return result;
+    }
+
+private:
+    /** does the checking stop at the given for loop? */
+    bool bailout(unsigned int loop)
+    {
+        if (_forBailout[loop] == 0)
         {
-            const MathLib::bigint index = MathLib::toLongNumber(tok->strAt(3));
-            if (index < 0 || index > arrayInfo.num[0])
-            {
-                pointerOutOfBounds(tok->next(), "array");
-            }
+            ForLoop info;
+            for_loop(_tokens[_forLoops[loop]], info);
+            _forBailout[loop] = info.bailout ? 1 : 2;
         }
+        return _forBailout[loop] == 1;
     }
-}
 
+    /** all tokens */
+    std::vector<const Token *> _tokens;
 
-//---------------------------------------------------------------------------
-// Checking local variables in a scope
-//---------------------------------------------------------------------------
+    /** position of the "{" that each token is in */
+    std::vector<unsigned int> _enclosing;
+
+    /** position of the "}" for each "{" */
+    std::vector<unsigned int> _end;
+
+    /** positions of the tokens for each variable id */
+    std::map<unsigned int, std::vector<unsigned int> > _varUses;
+
+    /** positions of the for loops */
+    std::vector<unsigned int> _forLoops;
+
+    /** position of the end of each for loop body */
+    std::vector<unsigned int> _forBodyEnd;
+
+    /** does the checking stop at each for loop? 0 => not known yet, 1 => yes, 2 => no */
+    std::vector<char> _forBailout;
+};
 
 void CheckBufferOverrun::checkGlobalAndLocalVariable()
 {
+    ArrayUses arrayUses(_tokenizer->tokens());
+
     // Count { and } when parsing all tokens
     int indentlevel = 0;
-    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
+    unsigned int pos = 0;
+    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next(), ++pos)
     {
         if (tok->str() == "{")
             ++indentlevel;
@@ -1249,10 +1518,17 @@ void CheckBufferOverrun::checkGlobalAndLocalVariable()
         if (arrayInfo.declare(tok, *_tokenizer))
         {
             while (tok && tok->str() != ";")
+            {
                 tok = tok->next();
+                ++pos;
+            }
             if (!tok)
                 break;
-            checkScope(tok, arrayInfo);
+            assert(arrayUses.token(pos) == tok);
+            if (arrayInfo.varid)
+                checkScope(arrayUses.uses(arrayInfo.varid, pos), arrayInfo);
+            else
+                checkScope(tok, arrayInfo);
             continue;
         }
 
@@ -2207,7 +2483,7 @@ void CheckBufferOverrun::executionPaths()
 
     // Perform checking - check how the arrayInfo arrays are used
     ExecutionPathBufferOverrun c(this, arrayInfo);
-    checkExecutionPaths(_tokenizer->tokens(), &c);
+    checkExecutionPaths(_tokenizer->tokens(), &c, _settings->_checkJobs);
 }
 
 
@@ -26,6 +26,7 @@
 #include "settings.h"
 #include "mathlib.h"
 #include <list>
+#include <map>
 #include <vector>
 #include <string>
 
@@ -164,6 +165,20 @@ public:
     /** Check for buffer overruns (based on ArrayInfo) */
     void checkScope(const Token *tok, const ArrayInfo &arrayInfo);
 
+    /**
+     * Check for buffer overruns (based on ArrayInfo). Only the given tokens
+     * in the scope are checked.
+     * @param uses the tokens in the scope where the array might be used, in order
+     * @param arrayInfo the array information
+     */
+    void checkScope(const std::vector<const Token *> &uses, const ArrayInfo &arrayInfo);
+
+    /**
+     * Check scope helper function - check a token in the scope
+     * @return false if the checking of the array should stop
+     */
+    bool checkScopeToken(const Token *tok, const ArrayInfo &arrayInfo);
+
     /** Check scope helper function - parse for body */
     void checkScopeForBody(const Token *tok, const ArrayInfo &arrayInfo, bool &bailout);
 
@@ -178,6 +193,16 @@ public:
      */
     void checkFunctionParameter(const Token &tok, const unsigned int par, const ArrayInfo &arrayInfo);
 
+    /**
+     * Helper function for checkFunctionParameter - get the array accesses
+     * "parameter [ %num% ]" in a function body. The result is the same
+     * for each call, so it is cached.
+     * \param ftok token for the function name in the function implementation
+     * \param par the parameter
+     * \return the tokens for the parameter where it is accessed
+     */
+    const std::vector<const Token *> &parameterIndexes(const Token *ftok, unsigned int par);
+
     /**
      * Helper function that checks if the array is used and if so calls the checkFunctionCall
      * @param tok token that matches "%var% ("
@@ -220,6 +245,10 @@ public:
     {
         return "out of bounds checking";
     }
+
+private:
+    /** cached results of parameterIndexes */
+    std::map<std::pair<const Token *, unsigned int>, std::vector<const Token *> > _parameterIndexes;
 };
 /// @}
 //---------------------------------------------------------------------------
@@ -197,9 +197,19 @@ CheckMemoryLeak::AllocType CheckMemoryLeak::getAllocationType(const Token *tok2,
     if (callstack && std::find(callstack->begin(), callstack->end(), ftok) != callstack->end())
         return No;
 
-    std::list<const Token *> cs;
+    // Call that is not nested in another function call => the result is always the same
     if (!callstack)
-        callstack = &cs;
+    {
+        std::map<const Token *, AllocType>::const_iterator it = returnTypes.find(ftok);
+        if (it != returnTypes.end())
+            return it->second;
+
+        std::list<const Token *> cs;
+        cs.push_back(ftok);
+        const AllocType allocType = functionReturnType(ftok, &cs);
+        returnTypes[ftok] = allocType;
+        return allocType;
+    }
 
     callstack->push_back(ftok);
     return functionReturnType(ftok, callstack);
@@ -354,6 +364,7 @@ void CheckMemoryLeak::reportErr(const std::list<const Token *> &callstack, Sever
 
     const ErrorLogger::ErrorMessage errmsg(locations, severity, msg, id, false);
 
+    ++reportedErrors;
     if (errorLogger)
         errorLogger->reportErr(errmsg);
     else
@@ -482,6 +493,20 @@ CheckMemoryLeak::AllocType CheckMemoryLeak::functionReturnType(const Token *tok,
 
 
 const char *CheckMemoryLeak::functionArgAlloc(const Token *tok, unsigned int targetpar, AllocType &allocType) const
+{
+    const std::pair<const Token *, unsigned int> key(tok, targetpar);
+    std::map<std::pair<const Token *, unsigned int>, std::pair<const char *, AllocType> >::const_iterator it = argAllocs.find(key);
+    if (it == argAllocs.end())
+    {
+        const char *ret = parseFunctionArgAlloc(tok, targetpar, allocType);
+        it = argAllocs.insert(std::make_pair(key, std::make_pair(ret, allocType))).first;
+    }
+
+    allocType = it->second.second;
+    return it->second.first;
+}
+
+const char *CheckMemoryLeak::parseFunctionArgAlloc(const Token *tok, unsigned int targetpar, AllocType &allocType) const
 {
     // Find the varid of targetpar, then locate the start of the function..
     unsigned int parlevel = 0;
@@ -677,6 +702,45 @@ bool CheckMemoryLeakInFunction::test_white_list(const std::string &funcname)
                          sizeof(call_func_white_list[0]), call_func_white_list_compare) != NULL);
 }
 
+/**
+ * Create key for CheckMemoryLeakInFunction::callSummaries. The result of
+ * analysing a function body depends on the function, the parameter, the
+ * allocation/deallocation types so far and the names of the functions in
+ * the callstack (recursion / depth).
+ */
+static std::string callSummaryKey(const Token *ftok, unsigned int par, const std::list<const Token *> &callstack, CheckMemoryLeak::AllocType alloctype, CheckMemoryLeak::AllocType dealloctype, unsigned int sz)
+{
+    std::ostringstream key;
+    key << ftok << " " << par << " " << alloctype << " " << dealloctype << " " << sz;
+    for (std::list<const Token *>::const_iterator it = callstack.begin(); it != callstack.end(); ++it)
+        key << " " << ((*it) ? (*it)->str() : std::string());
+    return key.str();
+}
+
+bool CheckMemoryLeakInFunction::getCallSummary(const std::string &key, const char *&ret, AllocType &alloctype, AllocType &dealloctype) const
+{
+    std::map<std::string, CallSummary>::const_iterator it = callSummaries.find(key);
+    if (it == callSummaries.end())
+        return false;
+
+    ret = it->second.ret;
+    alloctype = it->second.alloctype;
+    dealloctype = it->second.dealloctype;
+    return true;
+}
+
+void CheckMemoryLeakInFunction::setCallSummary(const std::string &key, const char *ret, AllocType alloctype, AllocType dealloctype, unsigned int errors)
+{
+    // errors must be reported again for the next call
+    if (errors != reportedErrors)
+        return;
+
+    CallSummary &summary = callSummaries[key];
+    summary.ret = ret;
+    summary.alloctype = alloctype;
+    summary.dealloctype = dealloctype;
+}
+
 const char * CheckMemoryLeakInFunction::call_func(const Token *tok, std::list<const Token *> callstack, const unsigned int varid, AllocType &alloctype, AllocType &dealloctype, bool &allocpar, unsigned int sz)
 {
     if (test_white_list(tok->str()))
@@ -733,14 +797,20 @@ const char * CheckMemoryLeakInFunction::call_func(const Token *tok, std::list<co
         if (!ftok)
             return 0;
 
+        const std::string key(callSummaryKey(ftok, 0, callstack, alloctype, dealloctype, 1));
+        const char *ret = 0;
+        if (getCallSummary(key, ret, alloctype, dealloctype))
+            return ret;
+
+        const unsigned int errors = reportedErrors;
         Token *func = getcode(ftok->tokAt(1), callstack, 0, alloctype, dealloctype, false, 1);
         simplifycode(func);
-        const char *ret = 0;
         if (Token::simpleMatch(func, "; alloc ; }"))
             ret = "alloc";
         else if (Token::simpleMatch(func, "; dealloc ; }"))
             ret = "dealloc";
         Tokenizer::deleteTokens(func);
+        setCallSummary(key, ret, alloctype, dealloctype, errors);
         return ret;
     }
 
@@ -809,13 +879,19 @@ const char * CheckMemoryLeakInFunction::call_func(const Token *tok, std::list<co
                 // Check if the function deallocates the variable..
                 while (ftok && (ftok->str() != "{"))
                     ftok = ftok->next();
+
+                const std::string key(callSummaryKey(ftok, par, callstack, alloctype, dealloctype, sz));
+                const char *ret = 0;
+                if (getCallSummary(key, ret, alloctype, dealloctype))
+                    return ret;
+
+                const unsigned int errors = reportedErrors;
                 Token *func = getcode(ftok->tokAt(1), callstack, parameterVarid, alloctype, dealloctype, false, sz);
                 //simplifycode(func, all);
                 const Token *func_ = func;
                 while (func_ && func_->str() == ";")
                     func_ = func_->next();
 
-                const char *ret = 0;
                 /** @todo handle "goto" */
                 if (Token::findmatch(func_, "dealloc"))
                     ret = "dealloc";
@@ -825,6 +901,7 @@ const char * CheckMemoryLeakInFunction::call_func(const Token *tok, std::list<co
                     ret = "&use";
 
                 Tokenizer::deleteTokens(func);
+                setCallSummary(key, ret, alloctype, dealloctype, errors);
                 return ret;
             }
             if (varid > 0 && Token::Match(tok, "[,()] & %varid% [,()]", varid))
@@ -1646,6 +1723,44 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
 
 
 
+/** Is the string one of the given names? */
+static bool isOneOf(const std::string &str, const char * const names[])
+{
+    for (unsigned int i = 0; names[i]; ++i)
+    {
+        if (str == names[i])
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Quick test if any of the rules in the main simplification loop of
+ * CheckMemoryLeakInFunction::simplifycode can match at the given token.
+ * Each rule starts with a fixed token either at the given token or at the
+ * next token. If this returns false none of the rules match.
+ */
+static bool simplifycodeCandidate(const Token *tok)
+{
+    // rules that start at tok..
+    static const char * const first[] = { "if", "ifv", "while1", "alloc", "dealloc", "use", "loop", "do", "try", "case", "switch", 0 };
+    if (isOneOf(tok->str(), first))
+        return true;
+
+    const Token *next = tok->next();
+    if (!next)
+        return false;
+
+    // rules that start at the next token..
+    static const char * const second[] = { "{", "if", "if(var)", "if(!var)", "ifv", "else", "do", "loop", 0 };
+    if (isOneOf(next->str(), second))
+        return true;
+
+    // rules that start with "[;{}]" at tok..
+    static const char * const statement[] = { ";", "alloc", "dealloc", "use", "callfunc", "return", 0 };
+    return Token::Match(tok, "[;{}]") && isOneOf(next->str(), statement);
+}
+
 void CheckMemoryLeakInFunction::simplifycode(Token *tok)
 {
     {
@@ -1776,6 +1891,10 @@ void CheckMemoryLeakInFunction::simplifycode(Token *tok)
         // Main inner simplification loop
         for (Token *tok2 = tok; tok2; tok2 = tok2 ? tok2->next() : NULL)
         {
+            // Skip the rules if none of them can match here
+            if (!simplifycodeCandidate(tok2))
+                continue;
+
             // Delete extra ";"
             while (Token::Match(tok2, "[;{}] ;"))
             {
@@ -2576,11 +2695,65 @@ void CheckMemoryLeakInFunction::checkReallocUsage()
 // Checks for memory leaks inside function..
 //---------------------------------------------------------------------------
 
+/**
+ * Locate the variables in a function body that might be allocated or
+ * deallocated: variables that are assigned, deleted, passed to a function
+ * or have their address taken. Other variables can't leak so there is no
+ * need to check them.
+ * @param start the "{" token of the function body
+ * @param varids the located variables
+ * @return false if every variable must be checked
+ */
+static bool getAllocationCandidates(const Token *start, std::set<unsigned int> &varids)
+{
+    // is each open parenthesis a function call?
+    std::stack<bool> calls;
+    unsigned int callLevel = 0;
+
+    for (const Token *tok = start->next(); tok && tok != start->link(); tok = tok->next())
+    {
+        if (tok->str() == "(")
+        {
+            const bool call = tok->previous()->isName() && !Token::Match(tok->previous(), "if|for|while|switch|return");
+            calls.push(call);
+            if (call)
+                ++callLevel;
+        }
+        else if (tok->str() == ")")
+        {
+            if (!calls.empty())
+            {
+                if (calls.top())
+                    --callLevel;
+                calls.pop();
+            }
+        }
+
+        // fcloseall deallocates all files
+        else if (tok->str() == "fcloseall")
+            return false;
+
+        else if (tok->varId() > 0)
+        {
+            if (callLevel > 0 ||
+                tok->next()->str() == "=" ||
+                Token::Match(tok->previous(), "&|delete|]"))
+                varids.insert(tok->varId());
+        }
+    }
+
+    return true;
+}
+
 void CheckMemoryLeakInFunction::parseFunctionScope(const Token *tok, const Token *tok1, const bool classmember)
 {
     // Check locking/unlocking of global resources..
     checkScope(tok->next(), "", 0, classmember, 1);
 
+    // Only variables that can be allocated or deallocated are checked below
+    std::set<unsigned int> candidates;
+    const bool checkAll = !getAllocationCandidates(tok, candidates);
+
     // Locate parameters and check their usage..
     for (const Token *tok2 = tok1; tok2; tok2 = tok2->next())
     {
@@ -2592,6 +2765,8 @@ void CheckMemoryLeakInFunction::parseFunctionScope(const Token *tok, const Token
         {
             const std::string varname(tok2->strAt(3));
             const unsigned int varid = tok2->tokAt(3)->varId();
+            if (!checkAll && varid > 0 && candidates.find(varid) == candidates.end())
+                continue;
             const unsigned int sz = _tokenizer->sizeOfType(tok2->next());
             checkScope(tok->next(), varname, varid, classmember, sz);
         }
@@ -2630,27 +2805,27 @@ void CheckMemoryLeakInFunction::parseFunctionScope(const Token *tok, const Token
         if (Token::Match(tok->next(), "return|else"))
             continue;
 
-        unsigned int sz = _tokenizer->sizeOfType(tok->next());
-        if (sz < 1)
-            sz = 1;
-
+        const Token *vartok = 0;
         if (Token::Match(tok, "[{};] %type% * const| %var% [;=]"))
-        {
-            const Token *vartok = tok->tokAt(tok->tokAt(3)->str() != "const" ? 3 : 4);
-            checkScope(tok->next(), vartok->str(), vartok->varId(), classmember, sz);
-        }
+            vartok = tok->tokAt(tok->tokAt(3)->str() != "const" ? 3 : 4);
 
         else if (Token::Match(tok, "[{};] %type% %type% * const| %var% [;=]"))
-        {
-            const Token *vartok = tok->tokAt(tok->tokAt(4)->str() != "const" ? 4 : 5);
-            checkScope(tok->next(), vartok->str(), vartok->varId(), classmember, sz);
-        }
+            vartok = tok->tokAt(tok->tokAt(4)->str() != "const" ? 4 : 5);
 
         else if (Token::Match(tok, "[{};] int %var% [;=]"))
-        {
-            const Token *vartok = tok->tokAt(2);
-            checkScope(tok->next(), vartok->str(), vartok->varId(), classmember, sz);
-        }
+            vartok = tok->tokAt(2);
+
+        if (!vartok)
+            continue;
+
+        if (!checkAll && vartok->varId() > 0 && candidates.find(vartok->varId()) == candidates.end())
+            continue;
+
+        unsigned int sz = _tokenizer->sizeOfType(tok->next());
+        if (sz < 1)
+            sz = 1;
+
+        checkScope(tok->next(), vartok->str(), vartok->varId(), classmember, sz);
     }
     while (0 != (tok = tok->next()));
 }
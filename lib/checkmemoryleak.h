@@ -38,6 +38,7 @@
 #include "symboldatabase.h"
 
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -83,9 +84,13 @@ private:
      */
     void reportErr(const std::list<const Token *> &callstack, Severity::SeverityType severity, const std::string &id, const std::string &msg) const;
 
+protected:
+    /** Number of reported errors */
+    mutable unsigned int reportedErrors;
+
 public:
     CheckMemoryLeak(const Tokenizer *t, ErrorLogger *e)
-        : tokenizer(t), errorLogger(e)
+        : tokenizer(t), errorLogger(e), reportedErrors(0)
     {
 
     }
@@ -148,6 +153,16 @@ public:
 
     /** Function allocates pointed-to argument (a la asprintf)? */
     const char *functionArgAlloc(const Token *tok, unsigned int targetpar, AllocType &allocType) const;
+
+private:
+    /** Cached results of functionReturnType for calls that are not nested */
+    mutable std::map<const Token *, AllocType> returnTypes;
+
+    /** Cached results of functionArgAlloc. key: function, parameter */
+    mutable std::map<std::pair<const Token *, unsigned int>, std::pair<const char *, AllocType> > argAllocs;
+
+    /** Function allocates pointed-to argument? The result is not cached */
+    const char *parseFunctionArgAlloc(const Token *tok, unsigned int targetpar, AllocType &allocType) const;
 };
 
 /// @}
@@ -353,6 +368,36 @@ public:
     std::set<std::string> notnoreturn;
 
     const SymbolDatabase *symbolDatabase;
+
+    /** @brief How a called function handles a variable, see call_func */
+    struct CallSummary
+    {
+        const char *ret;
+        AllocType alloctype;
+        AllocType dealloctype;
+    };
+
+    /**
+     * Cached call_func results for analysed function bodies. The key
+     * is created by the callSummaryKey function
+     */
+    std::map<std::string, CallSummary> callSummaries;
+
+    /**
+     * Get cached result of analysing a function body in call_func
+     * @param key cache key
+     * @param ret the cached return value of call_func
+     * @param alloctype updated if the result is cached
+     * @param dealloctype updated if the result is cached
+     * @return true if the result is cached
+     */
+    bool getCallSummary(const std::string &key, const char *&ret, AllocType &alloctype, AllocType &dealloctype) const;
+
+    /**
+     * Cache result of analysing a function body in call_func. Nothing is
+     * cached if errors were reported during the analysis.
+     */
+    void setCallSummary(const std::string &key, const char *ret, AllocType alloctype, AllocType dealloctype, unsigned int errors);
 };
 
 
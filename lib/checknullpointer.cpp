@@ -1022,7 +1022,7 @@ void CheckNullPointer::executionPaths()
 {
     // Check for null pointer errors..
     Nullpointer c(this);
-    checkExecutionPaths(_tokenizer->tokens(), &c);
+    checkExecutionPaths(_tokenizer->tokens(), &c, _settings->_checkJobs);
 }
 
 void CheckNullPointer::nullPointerError(const Token *tok)
@@ -25,6 +25,7 @@
 #include <cctype> // std::isupper
 #include <cmath> // fabs()
 #include <stack>
+#include <vector>
 //---------------------------------------------------------------------------
 
 // Register this check class (by creating a static instance of it)
@@ -1015,8 +1016,64 @@ void ScopeInfo::remove(ScopeInfo *scope)
     }
 }
 
+/**
+ * @brief Set of variable indexes (see Variables). Each index is a bit so
+ * insert, erase and lookup don't allocate.
+ */
+class IndexSet
+{
+public:
+    /** returned by next() when there are no more indexes */
+    static const unsigned int npos = ~0U;
+
+    void insert(unsigned int index)
+    {
+        const unsigned int word = index / BITS;
+        if (word >= _bits.size())
+            _bits.resize(word + 1, 0);
+        _bits[word] |= (1UL << (index % BITS));
+    }
+
+    void erase(unsigned int index)
+    {
+        const unsigned int word = index / BITS;
+        if (word < _bits.size())
+            _bits[word] &= ~(1UL << (index % BITS));
+    }
+
+    void clear()
+    {
+        _bits.clear();
+    }
+
+    /** first index that is >= the given index, or npos */
+    unsigned int next(unsigned int index) const
+    {
+        unsigned int word = index / BITS;
+        if (word >= _bits.size())
+            return npos;
+        unsigned long bits = _bits[word] & (~0UL << (index % BITS));
+        while (bits == 0)
+        {
+            if (++word >= _bits.size())
+                return npos;
+            bits = _bits[word];
+        }
+        unsigned int bit = 0;
+        while (!(bits & (1UL << bit)))
+            ++bit;
+        return word * BITS + bit;
+    }
+
+private:
+    static const unsigned int BITS = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> _bits;
+};
+
 /**
  * @brief This class is used create a list of variables within a function.
+ * The variables are stored in a dense array. The array index of a variable
+ * is looked up by its varid, and the aliases are sets of array indexes.
  */
 class Variables
 {
@@ -1064,20 +1121,23 @@ public:
         bool _write;
         bool _modified; // read/modify/write
         bool _allocateMemory;
-        std::set<unsigned int> _aliases;
+        IndexSet _aliases;
         std::set<ScopeInfo *> _assignments;
     };
 
-    typedef std::map<unsigned int, VariableUsage> VariableMap;
+    Variables() : _offset(0)
+    { }
 
     void clear()
     {
         _varUsage.clear();
+        _index.clear();
+        _offset = 0;
     }
-    VariableMap &varUsage()
-    {
-        return _varUsage;
-    }
+
+    /** the variables, ordered by varid */
+    std::vector<const VariableUsage *> varUsage() const;
+
     void addVar(const Token *name, VariableType type, ScopeInfo *scope, bool write_);
     void allocateMemory(unsigned int varid);
     void read(unsigned int varid);
@@ -1090,18 +1150,53 @@ public:
     void modified(unsigned int varid);
     VariableUsage *find(unsigned int varid);
     void alias(unsigned int varid1, unsigned int varid2, bool replace);
+    void addAlias(VariableUsage *usage, unsigned int varid);
     void erase(unsigned int varid)
     {
-        _varUsage.erase(varid);
+        if (varid >= _offset && varid - _offset < _index.size())
+            _index[varid - _offset] = 0;
     }
     void eraseAliases(unsigned int varid);
     void eraseAll(unsigned int varid);
     void clearAliases(unsigned int varid);
 
 private:
-    VariableMap _varUsage;
+    /** array index of the given variable, or IndexSet::npos */
+    unsigned int index(unsigned int varid) const
+    {
+        if (varid == 0 || varid < _offset || varid - _offset >= _index.size() || _index[varid - _offset] == 0)
+            return IndexSet::npos;
+        return _index[varid - _offset] - 1;
+    }
+
+    /** variable with the given array index, or 0 if it has been erased */
+    VariableUsage *at(unsigned int i)
+    {
+        VariableUsage *usage = &_varUsage[i];
+        return (index(usage->_name->varId()) == i) ? usage : 0;
+    }
+
+    /** all variables, in the order they were added */
+    std::vector<VariableUsage> _varUsage;
+
+    /** array index + 1 of each varid from _offset and up, 0 if there is no such variable */
+    std::vector<unsigned int> _index;
+
+    /** the smallest varid in _index */
+    unsigned int _offset;
 };
 
+std::vector<const Variables::VariableUsage *> Variables::varUsage() const
+{
+    std::vector<const VariableUsage *> result;
+    for (unsigned int i = 0; i < _index.size(); ++i)
+    {
+        if (_index[i] > 0)
+            result.push_back(&_varUsage[_index[i] - 1]);
+    }
+    return result;
+}
+
 /**
  * Alias the 2 given variables. Either replace the existing aliases if
  * they exist or merge them.  You would replace an existing alias when this
@@ -1122,17 +1217,19 @@ void Variables::alias(unsigned int varid1, unsigned int varid2, bool replace)
         return;
     }
 
-    std::set<unsigned int>::iterator i;
+    const unsigned int index1 = index(varid1);
+    const unsigned int index2 = index(varid2);
+    unsigned int i;
 
     if (replace)
     {
         // remove var1 from all aliases
-        for (i = var1->_aliases.begin(); i != var1->_aliases.end(); ++i)
+        for (i = var1->_aliases.next(0); i != IndexSet::npos; i = var1->_aliases.next(i + 1))
         {
-            VariableUsage *temp = find(*i);
+            VariableUsage *temp = at(i);
 
             if (temp)
-                temp->_aliases.erase(var1->_name->varId());
+                temp->_aliases.erase(index1);
         }
 
         // remove all aliases from var1
@@ -1140,20 +1237,27 @@ void Variables::alias(unsigned int varid1, unsigned int varid2, bool replace)
     }
 
     // var1 gets all var2s aliases
-    for (i = var2->_aliases.begin(); i != var2->_aliases.end(); ++i)
+    for (i = var2->_aliases.next(0); i != IndexSet::npos; i = var2->_aliases.next(i + 1))
     {
-        if (*i != varid1)
-            var1->_aliases.insert(*i);
+        if (i != index1)
+            var1->_aliases.insert(i);
     }
 
     // var2 is an alias of var1
-    var2->_aliases.insert(varid1);
-    var1->_aliases.insert(varid2);
+    var2->_aliases.insert(index1);
+    var1->_aliases.insert(index2);
 
     if (var2->_type == Variables::pointer)
         var2->_read = true;
 }
 
+void Variables::addAlias(VariableUsage *usage, unsigned int varid)
+{
+    const unsigned int i = index(varid);
+    if (i != IndexSet::npos)
+        usage->_aliases.insert(i);
+}
+
 void Variables::clearAliases(unsigned int varid)
 {
     VariableUsage *usage = find(varid);
@@ -1161,14 +1265,14 @@ void Variables::clearAliases(unsigned int varid)
     if (usage)
     {
         // remove usage from all aliases
-        std::set<unsigned int>::iterator i;
+        const unsigned int self = index(varid);
 
-        for (i = usage->_aliases.begin(); i != usage->_aliases.end(); ++i)
+        for (unsigned int i = usage->_aliases.next(0); i != IndexSet::npos; i = usage->_aliases.next(i + 1))
         {
-            VariableUsage *temp = find(*i);
+            VariableUsage *temp = at(i);
 
             if (temp)
-                temp->_aliases.erase(usage->_name->varId());
+                temp->_aliases.erase(self);
         }
 
         // remove all aliases from usage
@@ -1182,10 +1286,13 @@ void Variables::eraseAliases(unsigned int varid)
 
     if (usage)
     {
-        std::set<unsigned int>::iterator aliases;
+        for (unsigned int i = usage->_aliases.next(0); i != IndexSet::npos; i = usage->_aliases.next(i + 1))
+        {
+            VariableUsage *aliased = at(i);
 
-        for (aliases = usage->_aliases.begin(); aliases != usage->_aliases.end(); ++aliases)
-            erase(*aliases);
+            if (aliased)
+                erase(aliased->_name->varId());
+        }
     }
 }
 
@@ -1200,8 +1307,22 @@ void Variables::addVar(const Token *name,
                        ScopeInfo *scope,
                        bool write_)
 {
-    if (name->varId() > 0)
-        _varUsage.insert(std::make_pair(name->varId(), VariableUsage(name, type, scope, false, write_, false)));
+    const unsigned int varid = name->varId();
+    if (varid == 0 || index(varid) != IndexSet::npos)
+        return;
+
+    if (_index.empty())
+        _offset = varid;
+    else if (varid < _offset)
+    {
+        _index.insert(_index.begin(), _offset - varid, 0);
+        _offset = varid;
+    }
+    if (varid - _offset >= _index.size())
+        _index.resize(varid - _offset + 1, 0);
+
+    _varUsage.push_back(VariableUsage(name, type, scope, false, write_, false));
+    _index[varid - _offset] = _varUsage.size();
 }
 
 void Variables::allocateMemory(unsigned int varid)
@@ -1226,11 +1347,9 @@ void Variables::readAliases(unsigned int varid)
 
     if (usage)
     {
-        std::set<unsigned int>::iterator aliases;
-
-        for (aliases = usage->_aliases.begin(); aliases != usage->_aliases.end(); ++aliases)
+        for (unsigned int i = usage->_aliases.next(0); i != IndexSet::npos; i = usage->_aliases.next(i + 1))
         {
-            VariableUsage *aliased = find(*aliases);
+            VariableUsage *aliased = at(i);
 
             if (aliased)
                 aliased->_read = true;
@@ -1245,16 +1364,7 @@ void Variables::readAll(unsigned int varid)
     if (usage)
     {
         usage->_read = true;
-
-        std::set<unsigned int>::iterator aliases;
-
-        for (aliases = usage->_aliases.begin(); aliases != usage->_aliases.end(); ++aliases)
-        {
-            VariableUsage *aliased = find(*aliases);
-
-            if (aliased)
-                aliased->_read = true;
-        }
+        readAliases(varid);
     }
 }
 
@@ -1272,11 +1382,9 @@ void Variables::writeAliases(unsigned int varid)
 
     if (usage)
     {
-        std::set<unsigned int>::iterator aliases;
-
-        for (aliases = usage->_aliases.begin(); aliases != usage->_aliases.end(); ++aliases)
+        for (unsigned int i = usage->_aliases.next(0); i != IndexSet::npos; i = usage->_aliases.next(i + 1))
         {
-            VariableUsage *aliased = find(*aliases);
+            VariableUsage *aliased = at(i);
 
             if (aliased)
                 aliased->_write = true;
@@ -1291,16 +1399,7 @@ void Variables::writeAll(unsigned int varid)
     if (usage)
     {
         usage->_write = true;
-
-        std::set<unsigned int>::iterator aliases;
-
-        for (aliases = usage->_aliases.begin(); aliases != usage->_aliases.end(); ++aliases)
-        {
-            VariableUsage *aliased = find(*aliases);
-
-            if (aliased)
-                aliased->_write = true;
-        }
+        writeAliases(varid);
     }
 }
 
@@ -1312,11 +1411,9 @@ void Variables::use(unsigned int varid)
     {
         usage->use();
 
-        std::set<unsigned int>::iterator aliases;
-
-        for (aliases = usage->_aliases.begin(); aliases != usage->_aliases.end(); ++aliases)
+        for (unsigned int i = usage->_aliases.next(0); i != IndexSet::npos; i = usage->_aliases.next(i + 1))
         {
-            VariableUsage *aliased = find(*aliases);
+            VariableUsage *aliased = at(i);
 
             if (aliased)
                 aliased->use();
@@ -1332,11 +1429,9 @@ void Variables::modified(unsigned int varid)
     {
         usage->_modified = true;
 
-        std::set<unsigned int>::iterator aliases;
-
-        for (aliases = usage->_aliases.begin(); aliases != usage->_aliases.end(); ++aliases)
+        for (unsigned int i = usage->_aliases.next(0); i != IndexSet::npos; i = usage->_aliases.next(i + 1))
         {
-            VariableUsage *aliased = find(*aliases);
+            VariableUsage *aliased = at(i);
 
             if (aliased)
                 aliased->_modified = true;
@@ -1346,13 +1441,8 @@ void Variables::modified(unsigned int varid)
 
 Variables::VariableUsage *Variables::find(unsigned int varid)
 {
-    if (varid)
-    {
-        VariableMap::iterator i = _varUsage.find(varid);
-        if (i != _varUsage.end())
-            return &i->second;
-    }
-    return 0;
+    const unsigned int i = index(varid);
+    return (i == IndexSet::npos) ? 0 : &_varUsage[i];
 }
 
 static int doAssignment(Variables &variables, const Token *tok, bool dereference, ScopeInfo *scope)
@@ -1927,13 +2017,13 @@ void CheckOther::functionVariableUsage()
 
                         if (var && (var->_type == Variables::array ||
                                     var->_type == Variables::pointer))
-                            var->_aliases.insert(tok->varId());
+                            variables.addAlias(var, tok->varId());
                     }
                     else
                     {
                         variables.readAll(tok->tokAt(4)->varId());
                         if (var)
-                            var->_aliases.insert(tok->varId());
+                            variables.addAlias(var, tok->varId());
                     }
                 }
                 tok = tok->tokAt(5);
@@ -2233,10 +2323,10 @@ void CheckOther::functionVariableUsage()
         }
 
         // Check usage of all variables in the current scope..
-        Variables::VariableMap::const_iterator it;
-        for (it = variables.varUsage().begin(); it != variables.varUsage().end(); ++it)
+        const std::vector<const Variables::VariableUsage *> varUsage(variables.varUsage());
+        for (std::vector<const Variables::VariableUsage *>::const_iterator it = varUsage.begin(); it != varUsage.end(); ++it)
         {
-            const Variables::VariableUsage &usage = it->second;
+            const Variables::VariableUsage &usage = **it;
             const std::string &varname = usage._name->str();
 
             // variable has been marked as unused so ignore it
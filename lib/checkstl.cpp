@@ -47,6 +47,8 @@ void CheckStl::dereferenceErasedError(const Token *tok, const std::string &itern
 
 void CheckStl::iterators()
 {
+    const SymbolDatabase *symbolDatabase = _tokenizer->getSymbolDatabase();
+
     // Using same iterator against different containers.
     // for (it = foo.begin(); it != bar.end(); ++it)
     for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
@@ -67,9 +69,17 @@ void CheckStl::iterators()
         // counter for { and }
         unsigned int indent = 0;
 
+        // A local iterator can't be used after the end of the scope it
+        // is declared in. Don't scan the rest of the file.
+        const Token *scopeEnd = 0;
+        const Variable *iteratorInfo = symbolDatabase->getVariableFromVarId(iteratorId);
+        if (iteratorInfo && iteratorInfo->scope() &&
+            (iteratorInfo->scope()->type == Scope::eFunction || iteratorInfo->scope()->isLocal()))
+            scopeEnd = iteratorInfo->scope()->classEnd;
+
         // Scan through the rest of the code and see if the iterator is
         // used against other containers.
-        for (const Token *tok2 = tok->tokAt(7); tok2; tok2 = tok2->next())
+        for (const Token *tok2 = tok->tokAt(7); tok2 && tok2 != scopeEnd; tok2 = tok2->next())
         {
             // If a { is found then count it and continue
             if (tok2->str() == "{" && ++indent)
@@ -100,7 +110,6 @@ void CheckStl::iterators()
                     // skip error message if container is a set..
                     if (tok2->varId() > 0)
                     {
-                        const SymbolDatabase *symbolDatabase = _tokenizer->getSymbolDatabase();
                         const Variable *variableInfo = symbolDatabase->getVariableFromVarId(tok2->varId());
                         const Token *decltok = variableInfo ? variableInfo->typeStartToken() : NULL;
 
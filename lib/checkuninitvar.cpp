@@ -1074,16 +1074,20 @@ void CheckUninitVar::saveAnalysisData(const std::set<std::string> &data) const
     UninitVar::uvarFunctions.insert(data.begin(), data.end());
 }
 
+void CheckUninitVar::getAnalysisData(std::set<std::string> &data) const
+{
+    data.insert(UninitVar::uvarFunctions.begin(), UninitVar::uvarFunctions.end());
+}
+
 void CheckUninitVar::executionPaths()
 {
     // check if variable is accessed uninitialized..
     {
-        // no writing if multiple threads are used (TODO: thread safe analysis?)
-        if (_settings->_jobs == 1)
-            UninitVar::analyseFunctions(_tokenizer->tokens(), UninitVar::uvarFunctions);
+        // With -j all files are analysed before the checking starts
+        UninitVar::analyseFunctions(_tokenizer->tokens(), UninitVar::uvarFunctions);
 
         UninitVar c(this);
-        checkExecutionPaths(_tokenizer->tokens(), &c);
+        checkExecutionPaths(_tokenizer->tokens(), &c, _settings->_checkJobs);
     }
 }
 
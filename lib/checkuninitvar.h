@@ -70,6 +70,9 @@ public:
     /** Save analysis results */
     void saveAnalysisData(const std::set<std::string> &data) const;
 
+    /** Get the analysis results that have been saved so far */
+    void getAnalysisData(std::set<std::string> &data) const;
+
     /** @brief new type of check: check execution paths */
     void executionPaths();
 
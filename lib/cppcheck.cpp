@@ -24,9 +24,13 @@
 #include "path.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <map>
 #include <stdexcept>
+#include <sstream>
+#include <vector>
 #include <ctime>
 #include "timer.h"
 
@@ -35,10 +39,142 @@
 #include <pcre.h>
 #endif
 
+#if (defined(__GNUC__) || defined(__sun)) && !defined(__MINGW32__)
+#define THREADING_MODEL_FORK
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <cstring>
+#include <errno.h>
+#endif
+
 static TimerResults S_timerResults;
 
+#ifdef THREADING_MODEL_FORK
+/**
+ * Error logger that is used by the checks in a child process. All output
+ * is written to a pipe so the parent process can report it.
+ * Format: type (1 byte), check index, data length, data
+ */
+class CheckOutputWriter : public ErrorLogger
+{
+public:
+    explicit CheckOutputWriter(int pipe) : _pipe(pipe), _check(0)
+    { }
+
+    /** set the index of the check that is currently run */
+    void check(unsigned int index)
+    {
+        _check = index;
+    }
+
+    void reportOut(const std::string &outmsg)
+    {
+        write('1', outmsg);
+    }
+
+    void reportErr(const ErrorLogger::ErrorMessage &msg)
+    {
+        write('2', msg.serialize());
+    }
+
+    /** write the analysis data that the checks have saved, one item per line */
+    void analysisData(const std::set<std::string> &data)
+    {
+        std::string out;
+        for (std::set<std::string>::const_iterator it = data.begin(); it != data.end(); ++it)
+            out += *it + "\n";
+        write('4', out);
+    }
+
+private:
+    void write(char type, const std::string &data)
+    {
+        const unsigned int len = static_cast<unsigned int>(data.size());
+        std::string out(1, type);
+        out.append(reinterpret_cast<const char *>(&_check), sizeof(_check));
+        out.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        out += data;
+
+        std::string::size_type pos = 0;
+        while (pos < out.size())
+        {
+            const ssize_t n = ::write(_pipe, out.data() + pos, out.size() - pos);
+            if (n <= 0)
+            {
+                std::cerr << "#### CppCheck::runChecksInParallel, write error" << std::endl;
+                _exit(0);
+            }
+            pos += static_cast<std::string::size_type>(n);
+        }
+    }
+
+    const int _pipe;
+    unsigned int _check;
+};
+
+/**
+ * Read the pipes of the child processes until they are all closed. The
+ * pipes are read as the output comes so no child waits for a full pipe.
+ * @param rpipes read ends of the pipes, they are closed
+ * @param output the output of each pipe
+ */
+static void readChildOutput(const std::vector<int> &rpipes, std::vector<std::string> &output)
+{
+    std::vector<struct pollfd> fds(rpipes.size());
+    for (unsigned int w = 0; w < rpipes.size(); ++w)
+    {
+        fds[w].fd = rpipes[w];
+        fds[w].events = POLLIN;
+        fds[w].revents = 0;
+    }
+
+    std::vector<struct pollfd>::size_type open = fds.size();
+    while (open > 0)
+    {
+        if (poll(&fds[0], static_cast<nfds_t>(fds.size()), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        for (unsigned int w = 0; w < fds.size(); ++w)
+        {
+            if (fds[w].fd < 0 || fds[w].revents == 0)
+                continue;
+
+            char buf[65536];
+            const ssize_t n = read(fds[w].fd, buf, sizeof(buf));
+            if (n > 0)
+                output[w].append(buf, static_cast<std::string::size_type>(n));
+            else if (n == 0 || errno != EINTR)
+            {
+                // The child is done. A negative fd is ignored by poll().
+                close(fds[w].fd);
+                fds[w].fd = -1;
+                --open;
+            }
+        }
+    }
+
+    // poll() failed, the rest of the pipes are read one by one
+    for (unsigned int w = 0; w < fds.size(); ++w)
+    {
+        if (fds[w].fd < 0)
+            continue;
+        char buf[65536];
+        ssize_t n;
+        while ((n = read(fds[w].fd, buf, sizeof(buf))) > 0)
+            output[w].append(buf, static_cast<std::string::size_type>(n));
+        close(fds[w].fd);
+    }
+}
+#endif
+
 CppCheck::CppCheck(ErrorLogger &errorLogger, bool useGlobalSuppressions)
-    : _useGlobalSuppressions(useGlobalSuppressions), _errorLogger(errorLogger)
+    : _useGlobalSuppressions(useGlobalSuppressions), _recordResults(false), _resultsFromCache(false), _errorLogger(errorLogger)
 {
     exitcode = 0;
 }
@@ -74,12 +210,41 @@ unsigned int CppCheck::check(const std::string &path, const std::string &content
     return retval;
 }
 
+/** Reports the messages to another ErrorLogger and keeps them for the results cache */
+class ResultsRecorder : public ErrorLogger
+{
+public:
+    ResultsRecorder(ErrorLogger &errorLogger, std::list<std::string> *results)
+        : _errorLogger(errorLogger), _results(results)
+    { }
+
+    void reportOut(const std::string &outmsg)
+    {
+        _errorLogger.reportOut(outmsg);
+    }
+
+    void reportErr(const ErrorLogger::ErrorMessage &msg)
+    {
+        if (_results)
+            _results->push_back("d" + msg.serialize());
+        _errorLogger.reportErr(msg);
+    }
+
+    void reportProgress(const std::string &filename, const char stage[], const unsigned int value)
+    {
+        _errorLogger.reportProgress(filename, stage, value);
+    }
+
+private:
+    ErrorLogger &_errorLogger;
+    std::list<std::string> *_results;
+};
+
 unsigned int CppCheck::processFile()
 {
     exitcode = 0;
 
-    // TODO: Should this be moved out to its own function so all the files can be
-    // analysed before any files are checked?
+    // With -j the ThreadExecutor analyses all files before the checking starts
     if (_settings.test_2_pass && _settings._jobs == 1)
     {
         const std::string printname = Path::toNativeSeparators(_filename);
@@ -89,8 +254,6 @@ unsigned int CppCheck::processFile()
         analyseFile(f, _filename);
     }
 
-    _errout.str("");
-
     if (_settings.terminated())
         return exitcode;
 
@@ -102,6 +265,22 @@ unsigned int CppCheck::processFile()
         _errorLogger.reportOut(std::string("Checking ") + fixedpath + std::string("..."));
     }
 
+    _recordResults = !_settings.cacheFile.empty() && !_settings._inlineSuppressions && !_settings.isEnabled("unusedFunction");
+    _results.clear();
+    _analysisData.clear();
+    const std::string analysisHash(_recordResults ? hashAnalysisData() : std::string());
+    _resultsFromCache = _recordResults && reportCachedResults(analysisHash);
+    if (_resultsFromCache)
+    {
+        _recordResults = false;
+        reportUnmatchedSuppressions(_settings.nomsg.getUnmatchedLocalSuppressions(_filename));
+        _errorList.clear();
+        return exitcode;
+    }
+
+    // Messages that are not reported through this class are kept too
+    ResultsRecorder recorder(_errorLogger, _recordResults ? &_results : 0);
+
     try
     {
         Preprocessor preprocessor(&_settings, this);
@@ -152,13 +331,13 @@ unsigned int CppCheck::processFile()
                                                  msg,
                                                  "toomanyconfigs",
                                                  false);
-                _errorLogger.reportErr(errmsg);
+                recorder.reportErr(errmsg);
                 break;
             }
 
             cfg = *it;
             Timer t("Preprocessor::getcode", _settings._showtime, &S_timerResults);
-            const std::string codeWithoutCfg = Preprocessor::getcode(filedata, *it, _filename, &_settings, &_errorLogger);
+            const std::string codeWithoutCfg = Preprocessor::getcode(filedata, *it, _filename, &_settings, &recorder);
             t.Stop();
 
             // If only errors are printed, print filename after the check
@@ -176,6 +355,16 @@ unsigned int CppCheck::processFile()
             checkFile(codeWithoutCfg + appendCode, _filename.c_str());
             ++checkCount;
         }
+
+        if ((_recordResults || !_settings.analysisFile.empty()) && !_settings.terminated())
+        {
+            std::ostringstream dependencies;
+            writeDependencies(dependencies, _filename, _fileContent, filedata, preprocessor.missingIncludeFiles());
+            if (_recordResults)
+                cacheResults(dependencies.str(), analysisHash);
+            if (!_settings.analysisFile.empty())
+                storeAnalysisData(_filename, dependencies.str(), _analysisData);
+        }
     }
     catch (std::runtime_error &e)
     {
@@ -183,6 +372,7 @@ unsigned int CppCheck::processFile()
         const std::string fixedpath = Path::toNativeSeparators(_filename);
         _errorLogger.reportOut("Bailing out from checking " + fixedpath + ": " + e.what());
     }
+    _recordResults = false;
 
     reportUnmatchedSuppressions(_settings.nomsg.getUnmatchedLocalSuppressions(_filename));
 
@@ -191,7 +381,6 @@ unsigned int CppCheck::processFile()
     _settings._verbose = false;
     if (_settings.isEnabled("unusedFunctions") && _settings._jobs == 1)
     {
-        _errout.str("");
         if (_settings._errorsOnly == false)
             _errorLogger.reportOut("Checking usage of global functions..");
 
@@ -226,14 +415,400 @@ void CppCheck::analyseFile(std::istream &fin, const std::string &filename)
     }
 
     // Save analysis results..
-    // TODO: This loop should be protected by a mutex or something like that
-    //       The saveAnalysisData must _not_ be called from many threads at the same time.
+    saveAnalysisData(data);
+
+    // ..and keep them for the file. With -j they are sent to the parent.
+    std::ostringstream dependencies;
+    writeDependencies(dependencies, filename, "", filedata, preprocessor.missingIncludeFiles());
+    storeAnalysisData(filename, dependencies.str(), data);
+}
+
+void CppCheck::saveAnalysisData(const std::set<std::string> &data)
+{
+    // The saveAnalysisData must _not_ be called from many threads at the same time.
+    // With -j the ThreadExecutor calls this in the parent process only.
     for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
     {
         (*it)->saveAnalysisData(data);
     }
 }
 
+void CppCheck::getAnalysisData(std::set<std::string> &data)
+{
+    for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
+    {
+        (*it)->getAnalysisData(data);
+    }
+}
+
+//---------------------------------------------------------------------------
+// Results cache and analysis file. The results and the analysis data of
+// each file are kept together with the files that it includes and a hash
+// of their contents. The strings are written with their length in front
+// of them.
+//---------------------------------------------------------------------------
+
+/** The cached results, the key is the file name */
+static std::map<std::string, std::string> &resultsCache()
+{
+    static std::map<std::string, std::string> _resultsCache;
+    return _resultsCache;
+}
+
+/** The analysis data of the files, the key is the file name */
+static std::map<std::string, std::string> &fileAnalysisData()
+{
+    static std::map<std::string, std::string> _fileAnalysisData;
+    return _fileAnalysisData;
+}
+
+/** The settings that change the results. The cache is not used if they change. */
+static std::string resultsCacheKey(const Settings &settings)
+{
+    std::ostringstream key;
+    key << "cppcheck " << CppCheck::version();
+    const char * const ids[] = { "information", "missingInclude", "unusedFunction" };
+    for (unsigned int i = 0; i < sizeof(ids) / sizeof(ids[0]); ++i)
+    {
+        if (settings.isEnabled(ids[i]))
+            key << " --enable=" << ids[i];
+    }
+    key << " " << settings.debugwarnings << settings.inconclusive << settings.experimental
+        << settings._checkCodingStyle << settings._force << settings.test_2_pass;
+    key << " -D" << settings.userDefines;
+    for (std::list<std::string>::const_iterator it = settings._includePaths.begin(); it != settings._includePaths.end(); ++it)
+        key << " -I" << *it;
+    for (std::list<Settings::Rule>::const_iterator it = settings.rules.begin(); it != settings.rules.end(); ++it)
+        key << " --rule=" << it->pattern << " " << it->id << " " << it->severity << " " << it->summary;
+    key << " --append=" << settings.append();
+    return key.str();
+}
+
+static void writeCacheString(std::ostream &ostr, const std::string &str)
+{
+    ostr << str.length() << " " << str;
+}
+
+static bool readCacheString(std::istream &istr, std::string &str)
+{
+    std::string::size_type len = 0;
+    if (!(istr >> len) || istr.get() != ' ')
+        return false;
+
+    // The string is read in pieces so a corrupt length can't make it
+    // bigger than the data that is left in the stream
+    str.clear();
+    char buf[4096];
+    while (len > 0)
+    {
+        istr.read(buf, static_cast<std::streamsize>(std::min(len, sizeof(buf))));
+        const std::string::size_type count = static_cast<std::string::size_type>(istr.gcount());
+        if (count == 0)
+            return false;
+        str.append(buf, count);
+        len -= count;
+    }
+    return true;
+}
+
+/** The size and a FNV-1a hash of the data */
+static std::string hashContent(std::istream &istr)
+{
+    unsigned long hash = 2166136261UL;
+    unsigned long size = 0;
+    char buf[4096];
+    while (istr.read(buf, sizeof(buf)) || istr.gcount() > 0)
+    {
+        const std::streamsize count = istr.gcount();
+        for (std::streamsize i = 0; i < count; ++i)
+        {
+            hash = ((hash ^ static_cast<unsigned char>(buf[i])) * 16777619UL) & 0xffffffffUL;
+        }
+        size += static_cast<unsigned long>(count);
+    }
+    std::ostringstream ostr;
+    ostr << size << ":" << hash;
+    return ostr.str();
+}
+
+/** Hash the content of a file, an empty string is returned if the file can't be read */
+static std::string hashFile(const std::string &filename)
+{
+    std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!fin.is_open())
+        return "";
+    return hashContent(fin);
+}
+
+std::string CppCheck::hashAnalysisData()
+{
+    std::set<std::string> data;
+    getAnalysisData(data);
+    std::ostringstream ostr;
+    for (std::set<std::string>::const_iterator it = data.begin(); it != data.end(); ++it)
+        writeCacheString(ostr, *it);
+    std::istringstream istr(ostr.str());
+    return hashContent(istr);
+}
+
+/**
+ * Read the files that were written by CppCheck::writeDependencies()
+ * @param istr the stream where the files are read from
+ * @param content the content of the checked file if it was not read
+ * from the disk
+ * @param compare compare the files with their hashes, else they are
+ * only read
+ * @return false if any of the files has changed
+ */
+static bool readDependencies(std::istream &istr, const std::string &content, bool compare = true)
+{
+    // The first file is the checked file, then come the included files
+    std::string count;
+    if (!readCacheString(istr, count))
+        return false;
+    const unsigned int fileCount = static_cast<unsigned int>(std::atoi(count.c_str()));
+    for (unsigned int i = 0; i < fileCount; ++i)
+    {
+        std::string filename, hash;
+        if (!readCacheString(istr, filename) || !readCacheString(istr, hash))
+            return false;
+
+        if (!compare)
+            continue;
+        if (i == 0 && !content.empty())
+        {
+            std::istringstream istrContent(content);
+            if (hashContent(istrContent) != hash)
+                return false;
+        }
+        else if (hashFile(filename) != hash)
+            return false;
+    }
+    return true;
+}
+
+/** Read the analysis data that comes after the files in an analysis entry */
+static bool readAnalysisItems(std::istream &istr, std::set<std::string> &items)
+{
+    std::string item;
+    while (readCacheString(istr, item))
+        items.insert(item);
+    return istr.eof();
+}
+
+void CppCheck::readResultsCache(std::istream &istr, const Settings &settings)
+{
+    std::string key;
+    if (!readCacheString(istr, key) || key != resultsCacheKey(settings))
+        return;
+
+    std::string filename, data;
+    while (readCacheString(istr, filename) && readCacheString(istr, data))
+        resultsCache()[filename] = data;
+}
+
+void CppCheck::writeResultsCache(std::ostream &ostr, const Settings &settings)
+{
+    writeCacheString(ostr, resultsCacheKey(settings));
+    for (std::map<std::string, std::string>::const_iterator it = resultsCache().begin(); it != resultsCache().end(); ++it)
+    {
+        writeCacheString(ostr, it->first);
+        writeCacheString(ostr, it->second);
+    }
+}
+
+bool CppCheck::getCachedResults(const std::string &filename, std::string &data)
+{
+    std::map<std::string, std::string>::const_iterator it = resultsCache().find(filename);
+    if (it == resultsCache().end())
+        return false;
+    data = it->second;
+    return true;
+}
+
+void CppCheck::setCachedResults(const std::string &filename, const std::string &data)
+{
+    resultsCache()[filename] = data;
+}
+
+bool CppCheck::reportCachedResults(const std::string &analysisHash)
+{
+    std::string data;
+    if (!getCachedResults(_filename, data))
+        return false;
+
+    std::istringstream istr(data);
+    if (!readDependencies(istr, _fileContent))
+        return false;
+    const std::string dependencies(data.substr(0, static_cast<std::string::size_type>(istr.tellg())));
+
+    // The results depend on the analysis data of the files that were
+    // checked before this file
+    std::string hash;
+    if (!readCacheString(istr, hash) || hash != analysisHash)
+        return false;
+
+    // The analysis data of the file
+    std::string count;
+    if (!readCacheString(istr, count))
+        return false;
+    const unsigned int itemCount = static_cast<unsigned int>(std::atoi(count.c_str()));
+    for (unsigned int i = 0; i < itemCount; ++i)
+    {
+        std::string item;
+        if (!readCacheString(istr, item))
+            return false;
+        _analysisData.insert(item);
+    }
+
+    // Read all messages before any of them is reported
+    std::list<std::pair<bool, ErrorLogger::ErrorMessage> > messages;
+    std::string message;
+    while (readCacheString(istr, message))
+    {
+        messages.push_back(std::make_pair(bool(!message.empty() && message[0] == 'd'), ErrorLogger::ErrorMessage()));
+        if (message.empty() || !messages.back().second.deserialize(message.substr(1)))
+            return false;
+        messages.back().second.file0 = _filename;
+    }
+
+    // Report the messages in the same way as they were reported when the
+    // file was checked
+    for (std::list<std::pair<bool, ErrorLogger::ErrorMessage> >::const_iterator it = messages.begin(); it != messages.end(); ++it)
+    {
+        if (it->first)
+            _errorLogger.reportErr(it->second);
+        else
+            reportErr(it->second);
+    }
+
+    // The analysis data is saved as if the file had been checked
+    saveAnalysisData(_analysisData);
+    if (!_settings.analysisFile.empty())
+        storeAnalysisData(_filename, dependencies, _analysisData);
+
+    return true;
+}
+
+void CppCheck::writeDependencies(std::ostream &ostr, const std::string &filename, const std::string &content, const std::string &filedata, const std::list<std::string> &missingFiles)
+{
+    // The checked file and the files that it includes
+    std::list<std::pair<std::string, std::string> > files;
+    if (!content.empty())
+    {
+        std::istringstream istr(content);
+        files.push_back(std::make_pair(filename, hashContent(istr)));
+    }
+    else
+        files.push_back(std::make_pair(filename, hashFile(filename)));
+
+    std::set<std::string> included;
+    std::string::size_type pos = 0;
+    while ((pos = filedata.find("#file \"", pos)) != std::string::npos)
+    {
+        pos += 7;
+        const std::string::size_type end = filedata.find('\"', pos);
+        if (end == std::string::npos)
+            break;
+        const std::string header(filedata.substr(pos, end - pos));
+        if (included.insert(header).second)
+            files.push_back(std::make_pair(header, hashFile(header)));
+        pos = end;
+    }
+
+    // The files that are missing must still be missing
+    for (std::list<std::string>::const_iterator it = missingFiles.begin(); it != missingFiles.end(); ++it)
+    {
+        if (included.insert(*it).second)
+            files.push_back(std::make_pair(*it, std::string()));
+    }
+
+    std::ostringstream count;
+    count << files.size();
+    writeCacheString(ostr, count.str());
+    for (std::list<std::pair<std::string, std::string> >::const_iterator it = files.begin(); it != files.end(); ++it)
+    {
+        writeCacheString(ostr, it->first);
+        writeCacheString(ostr, it->second);
+    }
+}
+
+void CppCheck::cacheResults(const std::string &dependencies, const std::string &analysisHash)
+{
+    std::ostringstream data;
+    data << dependencies;
+    writeCacheString(data, analysisHash);
+    std::ostringstream count;
+    count << _analysisData.size();
+    writeCacheString(data, count.str());
+    for (std::set<std::string>::const_iterator it = _analysisData.begin(); it != _analysisData.end(); ++it)
+        writeCacheString(data, *it);
+    for (std::list<std::string>::const_iterator it = _results.begin(); it != _results.end(); ++it)
+        writeCacheString(data, *it);
+
+    setCachedResults(_filename, data.str());
+}
+
+void CppCheck::readAnalysisFile(std::istream &istr)
+{
+    std::set<std::string> items;
+    std::string filename, data;
+    while (readCacheString(istr, filename) && readCacheString(istr, data))
+    {
+        // The data of a file that has changed or has been removed is dropped
+        std::istringstream entry(data);
+        std::set<std::string> fileItems;
+        if (!readDependencies(entry, "") || !readAnalysisItems(entry, fileItems))
+            continue;
+
+        items.insert(fileItems.begin(), fileItems.end());
+        fileAnalysisData()[filename] = data;
+    }
+
+    saveAnalysisData(items);
+}
+
+void CppCheck::writeAnalysisFile(std::ostream &ostr)
+{
+    for (std::map<std::string, std::string>::const_iterator it = fileAnalysisData().begin(); it != fileAnalysisData().end(); ++it)
+    {
+        writeCacheString(ostr, it->first);
+        writeCacheString(ostr, it->second);
+    }
+}
+
+bool CppCheck::getFileAnalysisData(const std::string &filename, std::string &data)
+{
+    std::map<std::string, std::string>::const_iterator it = fileAnalysisData().find(filename);
+    if (it == fileAnalysisData().end())
+        return false;
+    data = it->second;
+    return true;
+}
+
+void CppCheck::setFileAnalysisData(const std::string &filename, const std::string &data)
+{
+    fileAnalysisData()[filename] = data;
+}
+
+void CppCheck::saveFileAnalysisData(const std::string &data)
+{
+    std::istringstream entry(data);
+    std::set<std::string> items;
+    if (readDependencies(entry, "", false) && readAnalysisItems(entry, items))
+        saveAnalysisData(items);
+}
+
+void CppCheck::storeAnalysisData(const std::string &filename, const std::string &dependencies, const std::set<std::string> &data)
+{
+    std::ostringstream entry;
+    entry << dependencies;
+    for (std::set<std::string>::const_iterator it = data.begin(); it != data.end(); ++it)
+        writeCacheString(entry, *it);
+
+    setFileAnalysisData(filename, entry.str());
+}
+
 //---------------------------------------------------------------------------
 // CppCheck - A function that checks a specified file
 //---------------------------------------------------------------------------
@@ -263,13 +838,16 @@ void CppCheck::checkFile(const std::string &code, const char FileName[])
     timer2.Stop();
 
     // call all "runChecks" in all registered Check classes
-    for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
+    if (!runChecksInParallel(_tokenizer, false))
     {
-        if (_settings.terminated())
-            return;
+        for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
+        {
+            if (_settings.terminated())
+                return;
 
-        Timer timerRunChecks((*it)->name() + "::runChecks", _settings._showtime, &S_timerResults);
-        (*it)->runChecks(&_tokenizer, &_settings, this);
+            Timer timerRunChecks((*it)->name() + "::runChecks", _settings._showtime, &S_timerResults);
+            (*it)->runChecks(&_tokenizer, &_settings, this);
+        }
     }
 
     Timer timer3("Tokenizer::simplifyTokenList", _settings._showtime, &S_timerResults);
@@ -282,17 +860,27 @@ void CppCheck::checkFile(const std::string &code, const char FileName[])
     _tokenizer.fillFunctionList();
     timer4.Stop();
 
+    // Analysis data of the file for the analysis file and the results cache
+    if (!_settings.analysisFile.empty() || _recordResults)
+    {
+        for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
+            (*it)->analyse(_tokenizer.tokens(), _analysisData);
+    }
+
     if (_settings.isEnabled("unusedFunctions") && _settings._jobs == 1)
         _checkUnusedFunctions.parseTokens(_tokenizer);
 
     // call all "runSimplifiedChecks" in all registered Check classes
-    for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
+    if (!runChecksInParallel(_tokenizer, true))
     {
-        if (_settings.terminated())
-            return;
+        for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
+        {
+            if (_settings.terminated())
+                return;
 
-        Timer timerSimpleChecks((*it)->name() + "::runSimplifiedChecks", _settings._showtime, &S_timerResults);
-        (*it)->runSimplifiedChecks(&_tokenizer, &_settings, this);
+            Timer timerSimpleChecks((*it)->name() + "::runSimplifiedChecks", _settings._showtime, &S_timerResults);
+            (*it)->runSimplifiedChecks(&_tokenizer, &_settings, this);
+        }
     }
 
 #ifdef HAVE_RULES
@@ -372,6 +960,167 @@ void CppCheck::checkFile(const std::string &code, const char FileName[])
 #endif
 }
 
+bool CppCheck::runChecksInParallel(const Tokenizer &tokenizer, bool simplified)
+{
+#ifdef THREADING_MODEL_FORK
+    // The timer results can't be collected from the child processes
+    if (_settings._checkJobs <= 1 || _settings._showtime != SHOWTIME_NONE)
+        return false;
+
+    if (_settings.terminated())
+        return true;
+
+    // Half of the processes run the checks. The rest are shared by the
+    // checks in them, the execution path checks check the function bodies
+    // in parallel. With two processes both are used for the function bodies.
+    const std::vector<Check *> checks(Check::instances().begin(), Check::instances().end());
+    const unsigned int jobs = _settings._checkJobs;
+    const unsigned int workers = std::min<unsigned int>((jobs + 1) / 2, checks.size());
+    if (workers <= 1)
+        return false;
+
+    // Create the symbol database before forking so it is not created
+    // once in every child process
+    tokenizer.getSymbolDatabase();
+
+    // don't write buffered output in the child processes too
+    std::cout.flush();
+    std::cerr.flush();
+
+    // Start the child processes. Child process 'w' runs every
+    // 'workers'th check beginning with check 'w'.
+    std::vector<int> rpipes;
+    std::vector<pid_t> children;
+    for (unsigned int w = 0; w < workers; ++w)
+    {
+        int pipes[2];
+        if (pipe(pipes) == -1)
+            break;
+
+        const pid_t pid = fork();
+        if (pid < 0)
+        {
+            close(pipes[0]);
+            close(pipes[1]);
+            break;
+        }
+        else if (pid == 0)
+        {
+            close(pipes[0]);
+            CheckOutputWriter writer(pipes[1]);
+
+            // The processes that are left for the checks of this child
+            _settings._checkJobs = jobs / workers + ((w < jobs % workers) ? 1U : 0U);
+            for (unsigned int c = w; c < checks.size(); c += workers)
+            {
+                writer.check(c);
+                if (simplified)
+                    checks[c]->runSimplifiedChecks(&tokenizer, &_settings, &writer);
+                else
+                    checks[c]->runChecks(&tokenizer, &_settings, &writer);
+            }
+            std::set<std::string> data;
+            getAnalysisData(data);
+            writer.analysisData(data);
+            close(pipes[1]);
+            _exit(0);
+        }
+
+        close(pipes[1]);
+        rpipes.push_back(pipes[0]);
+        children.push_back(pid);
+    }
+
+    // Read the output of the child processes
+    std::vector<std::string> output(rpipes.size());
+    readChildOutput(rpipes, output);
+    for (unsigned int w = 0; w < children.size(); ++w)
+    {
+        int stat = 0;
+        waitpid(children[w], &stat, 0);
+        if (WIFSIGNALED(stat))
+        {
+            std::ostringstream oss;
+            oss << "Internal error: Child process crashed with signal " << WTERMSIG(stat);
+
+            std::list<ErrorLogger::ErrorMessage::FileLocation> locations;
+            locations.push_back(ErrorLogger::ErrorMessage::FileLocation(_filename, 0));
+            const ErrorLogger::ErrorMessage errmsg(locations,
+                                                   Severity::error,
+                                                   oss.str(),
+                                                   "cppcheckError",
+                                                   false);
+            _errorLogger.reportErr(errmsg);
+        }
+    }
+
+    // Sort the output by check..
+    std::vector<std::list<std::pair<char, std::string> > > checkOutput(checks.size());
+    for (unsigned int w = 0; w < output.size(); ++w)
+    {
+        const std::string &data = output[w];
+        const std::string::size_type headerSize = 1 + 2 * sizeof(unsigned int);
+        std::string::size_type pos = 0;
+        while (pos + headerSize <= data.size())
+        {
+            unsigned int c = 0;
+            unsigned int len = 0;
+            std::memcpy(&c, data.data() + pos + 1, sizeof(c));
+            std::memcpy(&len, data.data() + pos + 1 + sizeof(c), sizeof(len));
+            if (c >= checks.size() || pos + headerSize + len > data.size())
+                break;
+            checkOutput[c].push_back(std::make_pair(data[pos], data.substr(pos + headerSize, len)));
+            pos += headerSize + len;
+        }
+    }
+
+    // Checks that were not run because a child process couldn't be started
+    for (unsigned int c = 0; c < checks.size(); ++c)
+    {
+        if ((c % workers) < children.size())
+            continue;
+        if (simplified)
+            checks[c]->runSimplifiedChecks(&tokenizer, &_settings, this);
+        else
+            checks[c]->runChecks(&tokenizer, &_settings, this);
+    }
+
+    // ..and report it in the same order as if the checks were run one by one
+    for (unsigned int c = 0; c < checkOutput.size(); ++c)
+    {
+        std::list<std::pair<char, std::string> >::const_iterator it;
+        for (it = checkOutput[c].begin(); it != checkOutput[c].end(); ++it)
+        {
+            if (it->first == '1')
+            {
+                reportOut(it->second);
+            }
+            else if (it->first == '4')
+            {
+                std::set<std::string> data;
+                std::istringstream iss(it->second);
+                std::string item;
+                while (std::getline(iss, item))
+                    data.insert(item);
+                saveAnalysisData(data);
+            }
+            else
+            {
+                ErrorLogger::ErrorMessage msg;
+                msg.deserialize(it->second);
+                reportErr(msg);
+            }
+        }
+    }
+
+    return true;
+#else
+    (void)tokenizer;
+    (void)simplified;
+    return false;
+#endif
+}
+
 Settings &CppCheck::settings()
 {
     return _settings;
@@ -381,14 +1130,21 @@ Settings &CppCheck::settings()
 
 void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
-    const std::string errmsg = msg.toString(_settings._verbose);
-    if (errmsg.empty())
+    // Nothing would be written for this message
+    if (msg._callStack.empty() && msg._severity == Severity::none &&
+        (_settings._verbose ? msg.verboseMessage() : msg.shortMessage()).empty())
         return;
 
     // Alert only about unique errors
-    if (std::find(_errorList.begin(), _errorList.end(), errmsg) != _errorList.end())
+    const std::string errmsg(msg.serialize());
+    if (_errorList.find(errmsg) != _errorList.end())
         return;
 
+    // The suppressions are checked again when the message is reported
+    // from the results cache
+    if (_recordResults)
+        _results.push_back("f" + errmsg);
+
     std::string file;
     unsigned int line(0);
     if (!msg._callStack.empty())
@@ -411,16 +1167,9 @@ void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
     if (!_settings.nofail.isSuppressed(msg._id, file, line))
         exitcode = 1;
 
-    _errorList.push_back(errmsg);
-    std::string errmsg2(errmsg);
-    if (_settings._verbose)
-    {
-        errmsg2 += "\n    Defines=\'" + cfg + "\'\n";
-    }
+    _errorList.insert(errmsg);
 
     _errorLogger.reportErr(msg);
-
-    _errout << errmsg2 << std::endl;
 }
 
 void CppCheck::reportOut(const std::string &outmsg)
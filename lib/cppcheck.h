@@ -27,6 +27,7 @@
 #include <list>
 #include <sstream>
 #include <vector>
+#include <set>
 
 /// @addtogroup Core
 /// @{
@@ -101,6 +102,15 @@ public:
 
     virtual void reportStatus(unsigned int fileindex, unsigned int filecount, long sizedone, long sizetotal);
 
+    /**
+     * @brief Were the results of the last checked file reported from
+     * the results cache?
+     */
+    bool resultsFromCache() const
+    {
+        return _resultsFromCache;
+    }
+
     /**
      * @brief Terminate checking. The checking will be terminated as soon as possible.
      */
@@ -116,10 +126,95 @@ public:
     void getErrorMessages();
 
     /**
-     * @brief Analyse file - It's public so unit tests can be written
+     * @brief Analyse file - It's public so unit tests can be written.
+     * The analysis data is saved and kept for the file, see
+     * getFileAnalysisData().
      */
     void analyseFile(std::istream &f, const std::string &filename);
 
+    /**
+     * @brief Save analysis data in all registered Check classes. The
+     * data may come from other processes or from an earlier run.
+     * @param data analysis data
+     */
+    static void saveAnalysisData(const std::set<std::string> &data);
+
+    /**
+     * @brief Get the analysis data of all registered Check classes
+     * @param data container where the data is stored
+     */
+    static void getAnalysisData(std::set<std::string> &data);
+
+    /**
+     * @brief Read the results cache of an earlier run. A file is not
+     * checked again if it and the files that it includes have not
+     * changed. Its results are reported from the cache instead.
+     * @param istr the cache, as written by writeResultsCache()
+     * @param settings the cache is not used if it was written with
+     * other settings
+     */
+    static void readResultsCache(std::istream &istr, const Settings &settings);
+
+    /**
+     * @brief Write the results cache
+     * @param ostr the stream where the cache is written
+     * @param settings the settings that the results were got with
+     */
+    static void writeResultsCache(std::ostream &ostr, const Settings &settings);
+
+    /**
+     * @brief Get the cached results of a file
+     * @param filename the file
+     * @param data the results are stored here
+     * @return false if there are no results for the file
+     */
+    static bool getCachedResults(const std::string &filename, std::string &data);
+
+    /**
+     * @brief Set the cached results of a file. The results may come
+     * from another process.
+     * @param filename the file
+     * @param data the results, as given by getCachedResults()
+     */
+    static void setCachedResults(const std::string &filename, const std::string &data);
+
+    /**
+     * @brief Read the analysis data of an earlier run. The data of a
+     * file is dropped if the file or the files that it includes have
+     * changed or have been removed.
+     * @param istr the data, as written by writeAnalysisFile()
+     */
+    static void readAnalysisFile(std::istream &istr);
+
+    /**
+     * @brief Write the analysis data of the files
+     * @param ostr the stream where the data is written
+     */
+    static void writeAnalysisFile(std::ostream &ostr);
+
+    /**
+     * @brief Get the analysis data of a file
+     * @param filename the file
+     * @param data the analysis data is stored here
+     * @return false if there is no analysis data for the file
+     */
+    static bool getFileAnalysisData(const std::string &filename, std::string &data);
+
+    /**
+     * @brief Set the analysis data of a file. The data may come from
+     * another process.
+     * @param filename the file
+     * @param data the analysis data, as given by getFileAnalysisData()
+     */
+    static void setFileAnalysisData(const std::string &filename, const std::string &data);
+
+    /**
+     * @brief Save the analysis data of a file in all registered Check
+     * classes
+     * @param data the analysis data, as given by getFileAnalysisData()
+     */
+    static void saveFileAnalysisData(const std::string &data);
+
 private:
 
     /** @brief Process one file. */
@@ -128,6 +223,59 @@ private:
     /** @brief Check file */
     void checkFile(const std::string &code, const char FileName[]);
 
+    /** @brief A hash of the analysis data that the checks have now */
+    static std::string hashAnalysisData();
+
+    /**
+     * @brief Report the results of the file from the results cache.
+     * The analysis data of the file is saved too.
+     * @param analysisHash hash of the analysis data before the file
+     * is checked
+     * @return false if the file, the files that it includes or the
+     * analysis data have changed since the results were cached
+     */
+    bool reportCachedResults(const std::string &analysisHash);
+
+    /**
+     * @brief Save the results of the file in the results cache
+     * @param dependencies the files that the results depend on, as
+     * written by writeDependencies()
+     * @param analysisHash hash of the analysis data before the file
+     * was checked
+     */
+    void cacheResults(const std::string &dependencies, const std::string &analysisHash);
+
+    /**
+     * @brief Write the file and the files that it includes together
+     * with a hash of their contents
+     * @param ostr the stream where the files are written
+     * @param filename the checked file
+     * @param content the content of the file if it was not read from the disk
+     * @param filedata the preprocessed file
+     * @param missingFiles the paths where included files were searched
+     * for but not found, they must not appear either
+     */
+    static void writeDependencies(std::ostream &ostr, const std::string &filename, const std::string &content, const std::string &filedata, const std::list<std::string> &missingFiles);
+
+    /**
+     * @brief Keep the analysis data of a file
+     * @param filename the file
+     * @param dependencies the files that the data depends on, as
+     * written by writeDependencies()
+     * @param data the analysis data of the file
+     */
+    static void storeAnalysisData(const std::string &filename, const std::string &dependencies, const std::set<std::string> &data);
+
+    /**
+     * @brief Run all checks for the given token list in several child
+     * processes (Settings::_checkJobs). The output is reported in the
+     * same order as if the checks were run one by one.
+     * @param tokenizer tokenizer that has tokenized the file
+     * @param simplified run runSimplifiedChecks instead of runChecks
+     * @return false if the checks were not run
+     */
+    bool runChecksInParallel(const Tokenizer &tokenizer, bool simplified);
+
     /**
      * @brief Errors and warnings are directed here.
      *
@@ -145,13 +293,33 @@ private:
     virtual void reportOut(const std::string &outmsg);
 
     unsigned int exitcode;
-    std::list<std::string> _errorList;
-    std::ostringstream _errout;
+    std::set<std::string> _errorList;
     Settings _settings;
     bool _useGlobalSuppressions;
     std::string _filename;
     std::string _fileContent;
 
+    /**
+     * @brief Are the results of the file saved in the results cache?
+     * The messages are not kept with --inline-suppr because the inline
+     * suppressions are not read when the file is not checked. The
+     * unusedFunction check needs the tokens of all files.
+     */
+    bool _recordResults;
+
+    /** @brief Were the results of the file reported from the results cache? */
+    bool _resultsFromCache;
+
+    /**
+     * @brief The messages of the file for the results cache. The first
+     * character tells if the message was reported to this class or
+     * straight to the _errorLogger.
+     */
+    std::list<std::string> _results;
+
+    /** @brief The analysis data of the file for the analysis file and the results cache */
+    std::set<std::string> _analysisData;
+
     void reportProgress(const std::string &filename, const char stage[], const unsigned int value);
 
     CheckUnusedFunctions _checkUnusedFunctions;
@@ -22,6 +22,7 @@
 
 #include <sstream>
 #include <vector>
+#include <cstring>
 
 ErrorLogger::ErrorMessage::ErrorMessage()
     :_severity(Severity::none)
@@ -89,6 +90,16 @@ std::string ErrorLogger::ErrorMessage::serialize() const
     return oss.str();
 }
 
+/** Read len characters from the stream */
+static void readString(std::istream &istr, unsigned int len, std::string &str)
+{
+    if (len == 0)
+        return;
+    str.resize(len);
+    istr.read(&str[0], len);
+    str.resize(static_cast<std::string::size_type>(istr.gcount()));
+}
+
 bool ErrorLogger::ErrorMessage::deserialize(const std::string &data)
 {
     _inconclusive = false;
@@ -103,11 +114,7 @@ bool ErrorLogger::ErrorMessage::deserialize(const std::string &data)
 
         iss.get();
         std::string temp;
-        for (unsigned int i = 0; i < len && iss.good(); ++i)
-        {
-            char c = static_cast<char>(iss.get());
-            temp.append(1, c);
-        }
+        readString(iss, len, temp);
 
         if (temp == "inconclusive")
         {
@@ -137,11 +144,7 @@ bool ErrorLogger::ErrorMessage::deserialize(const std::string &data)
 
         iss.get();
         std::string temp;
-        for (unsigned int i = 0; i < len && iss.good(); ++i)
-        {
-            char c = static_cast<char>(iss.get());
-            temp.append(1, c);
-        }
+        readString(iss, len, temp);
 
         ErrorLogger::ErrorMessage::FileLocation loc;
         loc.setfile(temp.substr(temp.find(':') + 1));
@@ -188,50 +191,104 @@ std::string ErrorLogger::ErrorMessage::getXMLFooter(int xml_version)
     return (xml_version<=1) ? "</results>" : "  </errors>\n</results>";
 }
 
-static std::string stringToXml(std::string s)
+/** Append the number to the string */
+static void appendNumber(std::string &out, unsigned int value)
 {
-    // convert a string so it can be save as xml attribute data
-    std::string::size_type pos = 0;
-    while ((pos = s.find_first_of("<>&\"\n", pos)) != std::string::npos)
+    char buf[16];
+    char *p = buf + sizeof(buf);
+    do
     {
+        *--p = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    while (value > 0);
+    out.append(p, buf + sizeof(buf));
+}
+
+/** Append the string so it can be saved as xml attribute data */
+static void appendXml(std::string &out, const std::string &s)
+{
+    std::string::size_type start = 0;
+    std::string::size_type pos;
+    while ((pos = s.find_first_of("<>&\"\n", start)) != std::string::npos)
+    {
+        out.append(s, start, pos - start);
         if (s[pos] == '<')
-            s.insert(pos + 1, "&lt;");
+            out += "&lt;";
         else if (s[pos] == '>')
-            s.insert(pos + 1, "&gt;");
+            out += "&gt;";
         else if (s[pos] == '&')
-            s.insert(pos + 1, "&amp;");
+            out += "&amp;";
         else if (s[pos] == '"')
-            s.insert(pos + 1, "&quot;");
+            out += "&quot;";
         else if (s[pos] == '\n')
-            s.insert(pos + 1, "&#xa;");
-        s.erase(pos, 1);
-        ++pos;
+            out += "&#xa;";
+        start = pos + 1;
     }
-    return s;
+    out.append(s, start, std::string::npos);
+}
+
+/** Append the string as a JSON string, with quotes */
+static void appendJson(std::string &out, const std::string &s)
+{
+    out += '"';
+    for (std::string::const_iterator c = s.begin(); c != s.end(); ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            out += '\\';
+            out += *c;
+        }
+        else if (*c == '\n')
+            out += "\\n";
+        else if (*c == '\t')
+            out += "\\t";
+        else if (static_cast<unsigned char>(*c) < 0x20)
+        {
+            const char hex[] = "0123456789abcdef";
+            out += "\\u00";
+            out += hex[(*c >> 4) & 0xf];
+            out += hex[*c & 0xf];
+        }
+        else
+            out += *c;
+    }
+    out += '"';
 }
 
 std::string ErrorLogger::ErrorMessage::toXML(bool verbose, int version) const
+{
+    std::string xml;
+    writeXML(xml, verbose, version);
+    return xml;
+}
+
+void ErrorLogger::ErrorMessage::writeXML(std::string &out, bool verbose, int version) const
 {
     // Save this ErrorMessage as an XML element
-    std::ostringstream xml;
 
     // The default xml format
     if (version == 1)
     {
         // No inconclusive messages in the xml version 1
         if (_inconclusive)
-            return "";
+            return;
 
-        xml << "<error";
+        out += "<error";
         if (!_callStack.empty())
         {
-            xml << " file=\"" << stringToXml(_callStack.back().getfile()) << "\"";
-            xml << " line=\"" << _callStack.back().line << "\"";
+            out += " file=\"";
+            appendXml(out, _callStack.back().getfile());
+            out += "\" line=\"";
+            appendNumber(out, _callStack.back().line);
+            out += "\"";
         }
-        xml << " id=\"" << _id << "\"";
-        xml << " severity=\"" << (_severity == Severity::error ? "error" : "style") << "\"";
-        xml << " msg=\"" << stringToXml(verbose ? _verboseMessage : _shortMessage) << "\"";
-        xml << "/>";
+        out += " id=\"" + _id + "\"";
+        out += " severity=\"";
+        out += (_severity == Severity::error ? "error" : "style");
+        out += "\" msg=\"";
+        appendXml(out, verbose ? _verboseMessage : _shortMessage);
+        out += "\"/>";
     }
 
     // The xml format you get when you use --xml-version=2
@@ -239,77 +296,147 @@ std::string ErrorLogger::ErrorMessage::toXML(bool verbose, int version) const
     {
         // TODO: How should inconclusive messages be saved in the xml version 2?
         if (_inconclusive)
-            return "";
+            return;
 
-        xml << "  <error";
-        xml << " id=\"" << _id << "\"";
-        xml << " severity=\"" << Severity::toString(_severity) << "\"";
-        xml << " msg=\"" << stringToXml(_shortMessage) << "\"";
-        xml << " verbose=\"" << stringToXml(_verboseMessage) << "\"";
-        xml << ">" << std::endl;
+        out += "  <error id=\"" + _id + "\"";
+        out += " severity=\"" + Severity::toString(_severity) + "\"";
+        out += " msg=\"";
+        appendXml(out, _shortMessage);
+        out += "\" verbose=\"";
+        appendXml(out, _verboseMessage);
+        out += "\">\n";
 
         for (std::list<FileLocation>::const_reverse_iterator it = _callStack.rbegin(); it != _callStack.rend(); ++it)
         {
-            xml << "    <location";
-            xml << " file=\"" << stringToXml((*it).getfile()) << "\"";
-            xml << " line=\"" << (*it).line << "\"";
-            xml << "/>" << std::endl;
+            out += "    <location file=\"";
+            appendXml(out, (*it).getfile());
+            out += "\" line=\"";
+            appendNumber(out, (*it).line);
+            out += "\"/>\n";
         }
 
-        xml << "  </error>";
+        out += "  </error>";
     }
+}
 
-    return xml.str();
+void ErrorLogger::ErrorMessage::writeJSON(std::string &out) const
+{
+    // One JSON object per message, the locations are in the same
+    // order as in the xml version 2
+    out += "{\"id\":";
+    appendJson(out, _id);
+    out += ",\"severity\":";
+    appendJson(out, Severity::toString(_severity));
+    out += ",\"inconclusive\":";
+    out += (_inconclusive ? "true" : "false");
+    out += ",\"msg\":";
+    appendJson(out, _shortMessage);
+    out += ",\"verbose\":";
+    appendJson(out, _verboseMessage);
+    out += ",\"locations\":[";
+    for (std::list<FileLocation>::const_reverse_iterator it = _callStack.rbegin(); it != _callStack.rend(); ++it)
+    {
+        if (it != _callStack.rbegin())
+            out += ',';
+        out += "{\"file\":";
+        appendJson(out, (*it).getfile());
+        out += ",\"line\":";
+        appendNumber(out, (*it).line);
+        out += '}';
+    }
+    out += "]}";
 }
 
-void ErrorLogger::ErrorMessage::findAndReplace(std::string &source, const std::string &searchFor, const std::string &replaceWith)
+ErrorLogger::ErrorMessage::Template::Template(const std::string &format)
 {
-    std::string::size_type index = 0;
-    while ((index = source.find(searchFor, index)) != std::string::npos)
+    static const struct
+    {
+        const char *name;
+        FieldType type;
+    } names[] =
+    {
+        { "{file}", FileName },
+        { "{line}", LineNumber },
+        { "{severity}", SeverityName },
+        { "{message}", MessageText },
+        { "{id}", Id }
+    };
+
+    std::string::size_type start = 0;
+    std::string::size_type pos = 0;
+    while ((pos = format.find('{', pos)) != std::string::npos)
     {
-        source.replace(index, searchFor.length(), replaceWith);
-        index += replaceWith.length() - searchFor.length() + 1;
+        unsigned int i = 0;
+        while (i < sizeof(names) / sizeof(names[0]) && format.compare(pos, std::strlen(names[i].name), names[i].name) != 0)
+            ++i;
+        if (i == sizeof(names) / sizeof(names[0]))
+        {
+            ++pos;
+            continue;
+        }
+
+        if (pos > start)
+            _fields.push_back(std::make_pair(Text, format.substr(start, pos - start)));
+        _fields.push_back(std::make_pair(names[i].type, std::string()));
+        pos += std::strlen(names[i].name);
+        start = pos;
     }
+
+    if (start < format.length())
+        _fields.push_back(std::make_pair(Text, format.substr(start)));
 }
 
 std::string ErrorLogger::ErrorMessage::toString(bool verbose, const std::string &outputFormat) const
+{
+    std::string text;
+    writeString(text, verbose, Template(outputFormat));
+    return text;
+}
+
+void ErrorLogger::ErrorMessage::writeString(std::string &out, bool verbose, const Template &outputFormat) const
 {
     // Save this ErrorMessage in plain text.
 
     // No template is given
-    if (outputFormat.length() == 0)
+    if (outputFormat._fields.empty())
     {
-        std::ostringstream text;
         if (!_callStack.empty())
-            text << callStackToString(_callStack) << ": ";
+        {
+            writeCallStack(out, _callStack);
+            out += ": ";
+        }
         if (_severity != Severity::none)
-            text << "(" << Severity::toString(_severity) << ") ";
-        text << (verbose ? _verboseMessage : _shortMessage);
-        return text.str();
+            out += "(" + Severity::toString(_severity) + ") ";
+        out += (verbose ? _verboseMessage : _shortMessage);
+        return;
     }
 
-    // template is given. Reformat the output according to it
-    else
+    // template is given. Write the output according to it
+    for (std::vector<std::pair<Template::FieldType, std::string> >::const_iterator field = outputFormat._fields.begin(); field != outputFormat._fields.end(); ++field)
     {
-        std::string result = outputFormat;
-        findAndReplace(result, "{id}", _id);
-        findAndReplace(result, "{severity}", Severity::toString(_severity));
-        findAndReplace(result, "{message}", verbose ? _verboseMessage : _shortMessage);
-
-        if (!_callStack.empty())
+        switch (field->first)
         {
-            std::ostringstream oss;
-            oss << _callStack.back().line;
-            findAndReplace(result, "{line}", oss.str());
-            findAndReplace(result, "{file}", _callStack.back().getfile());
-        }
-        else
-        {
-            findAndReplace(result, "{file}", "");
-            findAndReplace(result, "{line}", "");
+        case Template::Text:
+            out += field->second;
+            break;
+        case Template::FileName:
+            if (!_callStack.empty())
+                out += _callStack.back().getfile();
+            break;
+        case Template::LineNumber:
+            if (!_callStack.empty())
+                appendNumber(out, _callStack.back().line);
+            break;
+        case Template::SeverityName:
+            out += Severity::toString(_severity);
+            break;
+        case Template::MessageText:
+            out += (verbose ? _verboseMessage : _shortMessage);
+            break;
+        case Template::Id:
+            out += _id;
+            break;
         }
-
-        return result;
     }
 }
 
@@ -325,15 +452,24 @@ void ErrorLogger::reportUnmatchedSuppressions(const std::list<Settings::Suppress
 
 std::string ErrorLogger::callStackToString(const std::list<ErrorLogger::ErrorMessage::FileLocation> &callStack)
 {
-    std::ostringstream ostr;
+    std::string str;
+    writeCallStack(str, callStack);
+    return str;
+}
+
+void ErrorLogger::writeCallStack(std::string &out, const std::list<ErrorLogger::ErrorMessage::FileLocation> &callStack)
+{
     for (std::list<ErrorLogger::ErrorMessage::FileLocation>::const_iterator tok = callStack.begin(); tok != callStack.end(); ++tok)
     {
-        ostr << (tok == callStack.begin() ? "" : " -> ") << "[" << (*tok).getfile();
+        out += (tok == callStack.begin() ? "[" : " -> [");
+        out += (*tok).getfile();
         if ((*tok).line != 0)
-            ostr << ":" << (*tok).line;
-        ostr << "]";
+        {
+            out += ':';
+            appendNumber(out, (*tok).line);
+        }
+        out += ']';
     }
-    return ostr.str();
 }
 
 
@@ -351,3 +487,8 @@ void ErrorLogger::ErrorMessage::FileLocation::setfile(const std::string &file)
     _file = file;
     _file = Path::fromNativeSeparators(_file);
 }
+
+void ErrorLogger::writeJSONString(std::string &out, const std::string &str)
+{
+    appendJson(out, str);
+}
@@ -22,6 +22,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include "settings.h"
 
@@ -188,6 +189,29 @@ public:
 
         };
 
+        /**
+         * Output template (--template) that has been split into text and
+         * fields. It is parsed once and then used for each message.
+         */
+        class Template
+        {
+        public:
+            /**
+             * Parse the template.
+             * @param format template, e.g. "{file}:{line},{severity},{id},{message}".
+             * Empty string to use the default output format.
+             */
+            explicit Template(const std::string &format = "");
+
+        private:
+            friend class ErrorMessage;
+
+            enum FieldType { Text, FileName, LineNumber, SeverityName, MessageText, Id };
+
+            /** The fields in the order they are written, the string is the text of Text fields */
+            std::vector<std::pair<FieldType, std::string> > _fields;
+        };
+
         ErrorMessage(const std::list<FileLocation> &callStack, Severity::SeverityType severity, const std::string &msg, const std::string &id, bool inconclusive);
         ErrorMessage();
 
@@ -198,6 +222,20 @@ public:
          */
         std::string toXML(bool verbose, int ver) const;
 
+        /**
+         * Write the error message in XML format to the end of the given string
+         * @param out string that the XML is appended to
+         * @param verbose use verbose message
+         * @param ver XML version
+         */
+        void writeXML(std::string &out, bool verbose, int ver) const;
+
+        /**
+         * Write the error message as a JSON object to the end of the given string
+         * @param out string that the JSON is appended to
+         */
+        void writeJSON(std::string &out) const;
+
         static std::string getXMLHeader(int xml_version);
         static std::string getXMLFooter(int xml_version);
 
@@ -209,6 +247,15 @@ public:
          */
         std::string toString(bool verbose, const std::string &outputFormat = "") const;
 
+        /**
+         * Format the error message into a string and write it to the end of
+         * the given string.
+         * @param out string that the message is appended to
+         * @param verbose use verbose message
+         * @param outputFormat the parsed output template
+         */
+        void writeString(std::string &out, bool verbose, const Template &outputFormat) const;
+
         std::string serialize() const;
         bool deserialize(const std::string &data);
 
@@ -236,15 +283,6 @@ public:
         }
 
     private:
-        /**
-         * Replace all occurrences of searchFor with replaceWith in the
-         * given source.
-         * @param source The string to modify
-         * @param searchFor What should be searched for
-         * @param replaceWith What will replace the found item
-         */
-        static void findAndReplace(std::string &source, const std::string &searchFor, const std::string &replaceWith);
-
         /** Short message */
         std::string _shortMessage;
 
@@ -285,6 +323,21 @@ public:
         (void)value;
     }
 
+    /**
+     * Report how many files have been checked
+     * @param fileindex this many files have been checked
+     * @param filecount this many files there are in total
+     * @param sizedone the sum of the sizes of the checked files
+     * @param sizetotal the total size of the files
+     */
+    virtual void reportStatus(unsigned int fileindex, unsigned int filecount, long sizedone, long sizetotal)
+    {
+        (void)fileindex;
+        (void)filecount;
+        (void)sizedone;
+        (void)sizetotal;
+    }
+
     /**
      * Report list of unmatched suppressions
      * @param unmatched list of unmatched suppressions (from Settings::Suppressions::getUnmatched(Local|Global)Suppressions)
@@ -292,6 +345,12 @@ public:
     void reportUnmatchedSuppressions(const std::list<Settings::Suppressions::SuppressionEntry> &unmatched);
 
     static std::string callStackToString(const std::list<ErrorLogger::ErrorMessage::FileLocation> &callStack);
+
+    /** Write the call stack to the end of the given string, in the same format as callStackToString() */
+    static void writeCallStack(std::string &out, const std::list<ErrorLogger::ErrorMessage::FileLocation> &callStack);
+
+    /** Write the string to the end of the given string as a JSON string, with quotes */
+    static void writeJSONString(std::string &out, const std::string &str);
 };
 
 
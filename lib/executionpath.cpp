@@ -19,11 +19,22 @@
 
 #include "executionpath.h"
 #include "token.h"
+#include "check.h"
+#include <algorithm>
 #include <memory>
 #include <set>
+#include <vector>
 #include <iterator>
 #include <iostream>
 
+#if (defined(__GNUC__) || defined(__sun)) && !defined(__MINGW32__)
+#define THREADING_MODEL_FORK
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <cstring>
+#endif
+
 
 
 // default : bail out if the condition is has variable handling
@@ -114,6 +125,7 @@ static void parseIfSwitchBody(const Token * const tok,
     {
         if (c.back()->varId == 0)
         {
+            delete c.back();
             c.pop_back();
             continue;
         }
@@ -129,7 +141,17 @@ static void parseIfSwitchBody(const Token * const tok,
                 break;
             }
         }
-        if (!duplicate)
+
+        // Is the same execution path already added by another branch?
+        for (it = newchecks.begin(); !duplicate && it != newchecks.end(); ++it)
+        {
+            if (*(*it) == *c.back() && (*it)->numberOfIf == c.back()->numberOfIf)
+                duplicate = true;
+        }
+
+        if (duplicate)
+            delete c.back();
+        else
             newchecks.push_back(c.back());
         c.pop_back();
     }
@@ -270,7 +292,10 @@ void ExecutionPath::checkScope(const Token *tok, std::list<ExecutionPath *> &che
                 for (std::list<ExecutionPath *>::iterator it = checks.begin(); it != checks.end();)
                 {
                     if ((*it)->numberOfIf > 0)
+                    {
+                        delete *it;
                         checks.erase(it++);
+                    }
                     else
                         ++it;
                 }
@@ -509,8 +534,186 @@ void ExecutionPath::checkScope(const Token *tok, std::list<ExecutionPath *> &che
     }
 }
 
-void checkExecutionPaths(const Token *tok, ExecutionPath *c)
+/** Check the execution paths of the function body that starts at the given "{" */
+static void checkFunction(const Token *tok, ExecutionPath *c)
+{
+    std::list<ExecutionPath *> checks;
+    checks.push_back(c->copy());
+    ExecutionPath::checkScope(tok, checks);
+
+    c->end(checks, tok->link());
+
+    while (!checks.empty())
+    {
+        delete checks.back();
+        checks.pop_back();
+    }
+}
+
+#ifdef THREADING_MODEL_FORK
+/**
+ * Error logger used in the child processes of checkExecutionPaths. The
+ * errors are written to a pipe.
+ * Format: function index, data length, serialized error message
+ */
+class FunctionErrorWriter : public ErrorLogger
+{
+public:
+    explicit FunctionErrorWriter(int pipe) : _pipe(pipe), _function(0), _failed(false)
+    { }
+
+    /** set the index of the function that is checked */
+    void function(unsigned int index)
+    {
+        _function = index;
+    }
+
+    /** did writing fail? */
+    bool failed() const
+    {
+        return _failed;
+    }
+
+    void reportOut(const std::string &)
+    { }
+
+    void reportErr(const ErrorLogger::ErrorMessage &msg)
+    {
+        const std::string data(msg.serialize());
+        const unsigned int len = static_cast<unsigned int>(data.size());
+        std::string out;
+        out.append(reinterpret_cast<const char *>(&_function), sizeof(_function));
+        out.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        out += data;
+
+        std::string::size_type pos = 0;
+        while (!_failed && pos < out.size())
+        {
+            const ssize_t n = ::write(_pipe, out.data() + pos, out.size() - pos);
+            if (n <= 0)
+                _failed = true;
+            else
+                pos += static_cast<std::string::size_type>(n);
+        }
+    }
+
+private:
+    const int _pipe;
+    unsigned int _function;
+    bool _failed;
+};
+
+/**
+ * Check the function bodies in child processes. Child process 'w' checks
+ * every 'workers'th function beginning with function 'w'. The errors are
+ * reported in the same order as if the functions were checked one by one.
+ * If a child process can't be started or fails, its functions are checked
+ * in this process instead.
+ * @param owner the check. Its errors are redirected in the child processes.
+ */
+static void checkFunctionsInParallel(const std::vector<const Token *> &bodies, ExecutionPath *c, Check *owner, unsigned int workers)
 {
+    ErrorLogger * const errorLogger = owner->errorLogger();
+
+    // don't write buffered output in the child processes too
+    std::cout.flush();
+    std::cerr.flush();
+
+    std::vector<int> rpipes(workers, -1);
+    std::vector<pid_t> children(workers, -1);
+    for (unsigned int w = 0; w < workers; ++w)
+    {
+        int pipes[2];
+        if (pipe(pipes) == -1)
+            continue;
+
+        const pid_t pid = fork();
+        if (pid < 0)
+        {
+            close(pipes[0]);
+            close(pipes[1]);
+            continue;
+        }
+        else if (pid == 0)
+        {
+            close(pipes[0]);
+            FunctionErrorWriter writer(pipes[1]);
+            owner->redirectErrors(&writer);
+            for (unsigned int i = w; i < bodies.size(); i += workers)
+            {
+                writer.function(i);
+                checkFunction(bodies[i], c);
+            }
+            close(pipes[1]);
+            _exit(writer.failed() ? 1 : 0);
+        }
+
+        close(pipes[1]);
+        rpipes[w] = pipes[0];
+        children[w] = pid;
+    }
+
+    // Read the errors from the child processes..
+    std::vector<std::list<std::string> > errors(bodies.size());
+    std::vector<bool> done(workers, false);
+    for (unsigned int w = 0; w < workers; ++w)
+    {
+        if (children[w] < 0)
+            continue;
+
+        std::string data;
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(rpipes[w], buf, sizeof(buf))) > 0)
+            data.append(buf, static_cast<std::string::size_type>(n));
+        close(rpipes[w]);
+
+        int stat = 0;
+        if (waitpid(children[w], &stat, 0) != children[w] || !WIFEXITED(stat) || WEXITSTATUS(stat) != 0)
+            continue;
+
+        const std::string::size_type headerSize = 2 * sizeof(unsigned int);
+        std::string::size_type pos = 0;
+        while (pos + headerSize <= data.size())
+        {
+            unsigned int i = 0;
+            unsigned int len = 0;
+            std::memcpy(&i, data.data() + pos, sizeof(i));
+            std::memcpy(&len, data.data() + pos + sizeof(i), sizeof(len));
+            if (i >= bodies.size() || pos + headerSize + len > data.size())
+                break;
+            errors[i].push_back(data.substr(pos + headerSize, len));
+            pos += headerSize + len;
+        }
+        done[w] = (pos == data.size());
+    }
+
+    // ..and report them
+    for (unsigned int i = 0; i < bodies.size(); ++i)
+    {
+        if (!done[i % workers])
+        {
+            checkFunction(bodies[i], c);
+            continue;
+        }
+
+        for (std::list<std::string>::const_iterator it = errors[i].begin(); it != errors[i].end(); ++it)
+        {
+            ErrorLogger::ErrorMessage msg;
+            msg.deserialize(*it);
+            if (errorLogger)
+                errorLogger->reportErr(msg);
+            else
+                Check::reportError(msg);
+        }
+    }
+}
+#endif
+
+void checkExecutionPaths(const Token *tok, ExecutionPath *c, unsigned int jobs)
+{
+    // Locate the function bodies..
+    std::vector<const Token *> bodies;
     for (; tok; tok = tok->next())
     {
         if (tok->str() != ")")
@@ -524,18 +727,23 @@ void checkExecutionPaths(const Token *tok, ExecutionPath *c)
             if (tok->str() == "const")
                 tok = tok->next();
 
-            std::list<ExecutionPath *> checks;
-            checks.push_back(c->copy());
-            ExecutionPath::checkScope(tok, checks);
-
-            c->end(checks, tok->link());
-
-            while (!checks.empty())
-            {
-                delete checks.back();
-                checks.pop_back();
-            }
+            bodies.push_back(tok);
         }
     }
-}
 
+#ifdef THREADING_MODEL_FORK
+    // Check the function bodies in parallel. Each child process
+    // should get a few functions.
+    const unsigned int workers = std::min<unsigned int>(jobs, bodies.size() / 4);
+    if (workers > 1 && c->getOwner())
+    {
+        checkFunctionsInParallel(bodies, c, c->getOwner(), workers);
+        return;
+    }
+#else
+    (void)jobs;
+#endif
+
+    for (unsigned int i = 0; i < bodies.size(); ++i)
+        checkFunction(bodies[i], c);
+}
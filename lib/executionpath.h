@@ -53,6 +53,12 @@ public:
     /** print checkdata */
     void print() const;
 
+    /** the check that this execution path belongs to */
+    Check *getOwner() const
+    {
+        return owner;
+    }
+
     /** number of if blocks */
     unsigned int numberOfIf;
 
@@ -136,8 +142,13 @@ public:
 };
 
 
-void checkExecutionPaths(const Token *tok, ExecutionPath *c);
-void checkExecutionPaths(const Token *tok, ExecutionPath *c);
+/**
+ * Check the execution paths of all function bodies
+ * @param tok first token
+ * @param c execution path that is copied for each function body
+ * @param jobs number of processes that check the function bodies
+ */
+void checkExecutionPaths(const Token *tok, ExecutionPath *c, unsigned int jobs = 1);
 
 
 #endif
@@ -1839,6 +1839,7 @@ void Preprocessor::handleIncludes(std::string &code, const std::string &filePath
     std::string::size_type pos = 0;
     std::string::size_type endfilePos = 0;
     std::set<std::string> handledFiles;
+    _missingIncludeFiles.clear();
     endfilePos = pos;
     while ((pos = code.find("#include", pos)) != std::string::npos)
     {
@@ -1887,6 +1888,7 @@ void Preprocessor::handleIncludes(std::string &code, const std::string &filePath
                 }
 
                 fin.clear();
+                _missingIncludeFiles.push_back(nativePath + filename);
             }
         }
 
@@ -1898,6 +1900,8 @@ void Preprocessor::handleIncludes(std::string &code, const std::string &filePath
                 filename = paths.back() + filename;
                 fileOpened = true;
             }
+            else
+                _missingIncludeFiles.push_back(paths.back() + filename);
         }
 
         if (fileOpened)
@@ -85,6 +85,15 @@ public:
      */
     void preprocess(std::istream &srcCodeStream, std::string &processedFile, std::list<std::string> &resultConfigurations, const std::string &filename, const std::list<std::string> &includePaths);
 
+    /**
+     * The paths where included files were searched for but not found.
+     * If a file is created in one of them the preprocessed code changes.
+     */
+    const std::list<std::string> &missingIncludeFiles() const
+    {
+        return _missingIncludeFiles;
+    }
+
     /** Just read the code into a string. Perform simple cleanup of the code */
     std::string read(std::istream &istr, const std::string &filename, Settings *settings);
 
@@ -233,6 +242,9 @@ private:
 
     /** filename for cpp/c file - useful when reporting errors */
     std::string file0;
+
+    /** paths where included files were searched for but not found */
+    std::list<std::string> _missingIncludeFiles;
 };
 
 /// @}
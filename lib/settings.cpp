@@ -37,7 +37,9 @@ Settings::Settings()
     _force = false;
     _xml = false;
     _xml_version = 1;
+    _json = false;
     _jobs = 1;
+    _checkJobs = 1;
     _exitCode = 0;
     _showtime = 0; // TODO: use enum
     _append = "";
@@ -200,6 +202,31 @@ bool Settings::Suppressions::FileMatcher::match(const std::string &pattern, cons
     }
 }
 
+void Settings::Suppressions::FileMatcher::addLine(std::map<unsigned int, unsigned int> &lines, unsigned int line)
+{
+    std::map<unsigned int, unsigned int>::const_iterator l = lines.find(line);
+    if (l != lines.end())
+    {
+        _matched[l->second] = false;
+    }
+    else
+    {
+        lines[line] = static_cast<unsigned int>(_matched.size());
+        _matched.push_back(false);
+    }
+}
+
+bool Settings::Suppressions::FileMatcher::isSuppressedLine(const std::map<unsigned int, unsigned int> &lines, unsigned int line)
+{
+    std::map<unsigned int, unsigned int>::const_iterator l = lines.find(0U);
+    if (l == lines.end())
+        l = lines.find(line);
+    if (l == lines.end())
+        return false;
+    _matched[l->second] = true;
+    return true;
+}
+
 std::string Settings::Suppressions::FileMatcher::addFile(const std::string &name, unsigned int line)
 {
     if (name.find_first_of("*?") != std::string::npos)
@@ -215,15 +242,17 @@ std::string Settings::Suppressions::FileMatcher::addFile(const std::string &name
                 }
             }
         }
-        _globs[name][line] = false;
+        addLine(_globs[name], line);
+        _globsForFile.clear();
     }
     else if (name.empty())
     {
-        _globs["*"][0U] = false;
+        addLine(_globs["*"], 0U);
+        _globsForFile.clear();
     }
     else
     {
-        _files[name][line] = false;
+        addLine(_files[name], line);
     }
     return "";
 }
@@ -233,48 +262,36 @@ bool Settings::Suppressions::FileMatcher::isSuppressed(const std::string &file,
     if (isSuppressedLocal(file, line))
         return true;
 
-    for (std::map<std::string, std::map<unsigned int, bool> >::iterator g = _globs.begin(); g != _globs.end(); ++g)
+    if (_globs.empty())
+        return false;
+
+    // Match the globs against each file only once
+    std::map<std::string, std::vector<const std::map<unsigned int, unsigned int> *> >::iterator globs = _globsForFile.find(file);
+    if (globs == _globsForFile.end())
     {
-        if (match(g->first, file))
+        globs = _globsForFile.insert(std::make_pair(file, std::vector<const std::map<unsigned int, unsigned int> *>())).first;
+        for (std::map<std::string, std::map<unsigned int, unsigned int> >::const_iterator g = _globs.begin(); g != _globs.end(); ++g)
         {
-            if (g->second.find(0U) != g->second.end())
-            {
-                g->second[0U] = true;
-                return true;
-            }
-            std::map<unsigned int, bool>::iterator l = g->second.find(line);
-            if (l != g->second.end())
-            {
-                l->second = true;
-                return true;
-            }
+            if (match(g->first, file))
+                globs->second.push_back(&g->second);
         }
     }
 
-    return false;
-}
-
-bool Settings::Suppressions::FileMatcher::isSuppressedLocal(const std::string &file, unsigned int line)
-{
-    std::map<std::string, std::map<unsigned int, bool> >::iterator f = _files.find(file);
-    if (f != _files.end())
+    for (std::vector<const std::map<unsigned int, unsigned int> *>::const_iterator g = globs->second.begin(); g != globs->second.end(); ++g)
     {
-        if (f->second.find(0U) != f->second.end())
-        {
-            f->second[0U] = true;
+        if (isSuppressedLine(**g, line))
             return true;
-        }
-        std::map<unsigned int, bool>::iterator l = f->second.find(line);
-        if (l != f->second.end())
-        {
-            l->second = true;
-            return true;
-        }
     }
 
     return false;
 }
 
+bool Settings::Suppressions::FileMatcher::isSuppressedLocal(const std::string &file, unsigned int line)
+{
+    std::map<std::string, std::map<unsigned int, unsigned int> >::const_iterator f = _files.find(file);
+    return bool(f != _files.end() && isSuppressedLine(f->second, line));
+}
+
 std::string Settings::Suppressions::addSuppression(const std::string &errorId, const std::string &file, unsigned int line)
 {
     // Check that errorId is valid..
@@ -302,26 +319,32 @@ std::string Settings::Suppressions::addSuppression(const std::string &errorId, c
 
 bool Settings::Suppressions::isSuppressed(const std::string &errorId, const std::string &file, unsigned int line)
 {
-    if (errorId != "unmatchedSuppression" && _suppressions.find("*") != _suppressions.end())
-        if (_suppressions["*"].isSuppressed(file, line))
+    std::map<std::string, FileMatcher>::iterator it;
+
+    if (errorId != "unmatchedSuppression" && (it = _suppressions.find("*")) != _suppressions.end())
+        if (it->second.isSuppressed(file, line))
             return true;
 
-    if (_suppressions.find(errorId) == _suppressions.end())
+    it = _suppressions.find(errorId);
+    if (it == _suppressions.end())
         return false;
 
-    return _suppressions[errorId].isSuppressed(file, line);
+    return it->second.isSuppressed(file, line);
 }
 
 bool Settings::Suppressions::isSuppressedLocal(const std::string &errorId, const std::string &file, unsigned int line)
 {
-    if (errorId != "unmatchedSuppression" && _suppressions.find("*") != _suppressions.end())
-        if (_suppressions["*"].isSuppressedLocal(file, line))
+    std::map<std::string, FileMatcher>::iterator it;
+
+    if (errorId != "unmatchedSuppression" && (it = _suppressions.find("*")) != _suppressions.end())
+        if (it->second.isSuppressedLocal(file, line))
             return true;
 
-    if (_suppressions.find(errorId) == _suppressions.end())
+    it = _suppressions.find(errorId);
+    if (it == _suppressions.end())
         return false;
 
-    return _suppressions[errorId].isSuppressedLocal(file, line);
+    return it->second.isSuppressedLocal(file, line);
 }
 
 std::list<Settings::Suppressions::SuppressionEntry> Settings::Suppressions::getUnmatchedLocalSuppressions(const std::string &file) const
@@ -329,12 +352,12 @@ std::list<Settings::Suppressions::SuppressionEntry> Settings::Suppressions::getU
     std::list<SuppressionEntry> r;
     for (std::map<std::string, FileMatcher>::const_iterator i = _suppressions.begin(); i != _suppressions.end(); ++i)
     {
-        std::map<std::string, std::map<unsigned int, bool> >::const_iterator f = i->second._files.find(file);
+        std::map<std::string, std::map<unsigned int, unsigned int> >::const_iterator f = i->second._files.find(file);
         if (f != i->second._files.end())
         {
-            for (std::map<unsigned int, bool>::const_iterator l = f->second.begin(); l != f->second.end(); ++l)
+            for (std::map<unsigned int, unsigned int>::const_iterator l = f->second.begin(); l != f->second.end(); ++l)
             {
-                if (!l->second)
+                if (!i->second._matched[l->second])
                 {
                     r.push_back(SuppressionEntry(i->first, f->first, l->first));
                 }
@@ -349,11 +372,11 @@ std::list<Settings::Suppressions::SuppressionEntry> Settings::Suppressions::getU
     std::list<SuppressionEntry> r;
     for (std::map<std::string, FileMatcher>::const_iterator i = _suppressions.begin(); i != _suppressions.end(); ++i)
     {
-        for (std::map<std::string, std::map<unsigned int, bool> >::const_iterator g = i->second._globs.begin(); g != i->second._globs.end(); ++g)
+        for (std::map<std::string, std::map<unsigned int, unsigned int> >::const_iterator g = i->second._globs.begin(); g != i->second._globs.end(); ++g)
         {
-            for (std::map<unsigned int, bool>::const_iterator l = g->second.begin(); l != g->second.end(); ++l)
+            for (std::map<unsigned int, unsigned int>::const_iterator l = g->second.begin(); l != g->second.end(); ++l)
             {
-                if (!l->second)
+                if (!i->second._matched[l->second])
                 {
                     r.push_back(SuppressionEntry(i->first, g->first, l->first));
                 }
@@ -24,6 +24,7 @@
 #include <istream>
 #include <map>
 #include <set>
+#include <vector>
 
 /// @addtogroup Core
 /// @{
@@ -99,10 +100,18 @@ public:
     /** @brief XML version (--xmlver=..) */
     int _xml_version;
 
+    /** @brief write results in JSON Lines format (--json) */
+    bool _json;
+
     /** @brief How many processes/threads should do checking at the same
         time. Default is 1. (-j N) */
     unsigned int _jobs;
 
+    /** @brief How many processes should run the checks of one file at
+        the same time. Default is 1. Used when -j is given and only
+        one file is checked. */
+    unsigned int _checkJobs;
+
     /** @brief If errors are found, this value is returned from main().
         Default value is 0. */
     int _exitCode;
@@ -148,10 +157,29 @@ public:
         {
             friend class Suppressions;
         private:
-            /** @brief List of filenames suppressed, bool flag indicates whether suppression matched. */
-            std::map<std::string, std::map<unsigned int, bool> > _files;
-            /** @brief List of globs suppressed, bool flag indicates whether suppression matched. */
-            std::map<std::string, std::map<unsigned int, bool> > _globs;
+            /** @brief List of filenames suppressed. Each line has an index in _matched. */
+            std::map<std::string, std::map<unsigned int, unsigned int> > _files;
+            /** @brief List of globs suppressed. Each line has an index in _matched. */
+            std::map<std::string, std::map<unsigned int, unsigned int> > _globs;
+            /** @brief Flag for each suppression that indicates whether it matched. */
+            std::vector<bool> _matched;
+            /** @brief The globs that match a filename, in the order of _globs. */
+            std::map<std::string, std::vector<const std::map<unsigned int, unsigned int> *> > _globsForFile;
+
+            /**
+             * @brief Add suppression for given line.
+             * @param lines The suppressed lines of a file or glob
+             * @param line Line number
+             */
+            void addLine(std::map<unsigned int, unsigned int> &lines, unsigned int line);
+
+            /**
+             * @brief Is line suppressed? Matching suppression is marked as matched.
+             * @param lines The suppressed lines of a file or glob
+             * @param line Line number
+             * @return true if the line is suppressed
+             */
+            bool isSuppressedLine(const std::map<unsigned int, unsigned int> &lines, unsigned int line);
 
             /**
              * @brief Match a name against a glob pattern.
@@ -162,6 +190,23 @@ public:
             static bool match(const std::string &pattern, const std::string &name);
 
         public:
+            FileMatcher()
+            { }
+
+            /** The cached glob matches point into _globs, so they are not copied */
+            FileMatcher(const FileMatcher &m)
+                : _files(m._files), _globs(m._globs), _matched(m._matched)
+            { }
+
+            FileMatcher &operator=(const FileMatcher &m)
+            {
+                _files = m._files;
+                _globs = m._globs;
+                _matched = m._matched;
+                _globsForFile.clear();
+                return *this;
+            }
+
             /**
              * @brief Add a file or glob (and line number).
              * @param name File name or glob pattern
@@ -271,6 +316,18 @@ public:
     /** @brief --report-progress */
     bool reportProgress;
 
+    /** @brief --analysis-file=<file>, analysis data that is kept between runs */
+    std::string analysisFile;
+
+    /** @brief --cost-file=<file>, check time of each file that is kept between runs */
+    std::string costFile;
+
+    /** @brief --progress-file=<file>, progress records in JSON format are written to this file */
+    std::string progressFile;
+
+    /** @brief --cache-file=<file>, results of the files that are kept between runs */
+    std::string cacheFile;
+
     /**
      * @brief Is there any preprocessor configurations in the source code?
      * As usual, include guards are not counted.
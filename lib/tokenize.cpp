@@ -800,6 +800,20 @@ struct Space
     const Token * classEnd;
 };
 
+/**
+ * Count how many times each name occurs in the token list. This is used
+ * by simplifyTypedef and simplifyEnum to see if a typedef or enumerator
+ * is used at all before the token list is searched for it.
+ */
+static void countNames(const Token *tokens, std::map<std::string, unsigned int> &names)
+{
+    for (const Token *tok = tokens; tok; tok = tok->next())
+    {
+        if (tok->isName())
+            ++names[tok->str()];
+    }
+}
+
 static Token *splitDefinitionFromTypedef(Token *tok)
 {
     Token *tok1;
@@ -952,6 +966,12 @@ void Tokenizer::simplifyTypedef()
     bool isNamespace = false;
     std::string className;
     bool hasClass = false;
+
+    // number of occurrences of each name. Typedefs that are not used
+    // anywhere don't need to be searched for.
+    std::map<std::string, unsigned int> names;
+    countNames(_tokens, names);
+
     for (Token *tok = _tokens; tok; tok = tok->next())
     {
         if (_errorLogger && !_files.empty())
@@ -998,6 +1018,8 @@ void Tokenizer::simplifyTypedef()
 
         // pull struct, union, enum or class definition out of typedef
         // use typedef name for unnamed struct, union, enum or class
+        // the split adds new names so the name counts can't be trusted
+        bool splitted = false;
         if (Token::Match(tok->next(), "const| struct|enum|union|class %type% {") ||
             Token::Match(tok->next(), "const| struct|enum|union|class {"))
         {
@@ -1005,6 +1027,7 @@ void Tokenizer::simplifyTypedef()
             if (!tok1)
                 continue;
             tok = tok1;
+            splitted = true;
         }
         else if (Token::Match(tok->next(), "const| struct|class %type% :"))
         {
@@ -1017,6 +1040,7 @@ void Tokenizer::simplifyTypedef()
                 if (!tok1)
                     continue;
                 tok = tok1;
+                splitted = true;
             }
         }
 
@@ -1397,7 +1421,11 @@ void Tokenizer::simplifyTypedef()
             int memberScope = 0;
             std::size_t classLevel = spaceInfo.size();
 
-            for (Token *tok2 = tok; tok2; tok2 = tok2->next())
+            // the typedef name must occur somewhere else than in the
+            // typedef itself, otherwise there is nothing to substitute
+            const bool used = splitted || names[typeName->str()] > 1;
+
+            for (Token *tok2 = used ? tok : 0; tok2; tok2 = tok2->next())
             {
                 // check for end of scope
                 if (tok2->str() == "}")
@@ -2912,7 +2940,7 @@ void Tokenizer::simplifyTemplatesUseDefaultArgumentValues(const std::list<Token
  */
 static bool simplifyTemplatesInstantiateMatch(const Token *instance, const std::string &name, unsigned int numberOfArguments, const char patternAfter[])
 {
-    if (!Token::simpleMatch(instance, (name + " <").c_str()))
+    if (instance->str() != name || !Token::simpleMatch(instance->next(), "<"))
         return false;
 
     if (numberOfArguments != templateParameters(instance->next()))
@@ -2988,6 +3016,17 @@ void Tokenizer::simplifyTemplatesInstantiate(const Token *tok,
 
     const bool isfunc(tok->strAt(namepos + 1) == "(");
 
+    // patterns for the template name
+    const std::string namePattern(name + " <");
+    const std::string nameNotTemplatePattern(name + " !!<");
+
+    // Where the template code is copied from: the template itself and
+    // member functions that are implemented outside the class definition.
+    // These are located when the template is instantiated the first time
+    // and reused for the other instantiations.
+    std::vector<const Token *> templateParts;
+    bool templatePartsLocated = false;
+
     // locate template usage..
     std::string::size_type sz1 = used.size();
     unsigned int recursiveCount = 0;
@@ -2999,6 +3038,7 @@ void Tokenizer::simplifyTemplatesInstantiate(const Token *tok,
         {
             sz1 = used.size();
             simplifyCalculations();
+            templatePartsLocated = false;
             recursiveCount++;
             if (recursiveCount > 100)
             {
@@ -3096,19 +3136,67 @@ void Tokenizer::simplifyTemplatesInstantiate(const Token *tok,
         if (expandedtemplates.find(name2) == expandedtemplates.end())
         {
             expandedtemplates.insert(name2);
+
+            // Locate the template code..
+            if (!templatePartsLocated)
+            {
+                templatePartsLocated = true;
+                templateParts.clear();
+
+                int _indentlevel = 0;
+                int _parlevel = 0;
+                for (const Token *tok3 = _tokens; tok3; tok3 = tok3->next())
+                {
+                    if (tok3->str() == "{")
+                        ++_indentlevel;
+                    else if (tok3->str() == "}")
+                        --_indentlevel;
+                    else if (tok3->str() == "(")
+                        ++_parlevel;
+                    else if (tok3->str() == ")")
+                        --_parlevel;
+
+                    // Start of template..
+                    if (tok3 == tok)
+                        templateParts.push_back(tok3);
+
+                    // member function implemented outside class definition
+                    else if (_indentlevel == 0 &&
+                             _parlevel == 0 &&
+                             simplifyTemplatesInstantiateMatch(tok3, name, type.size(), ":: ~| %var% ("))
+                        templateParts.push_back(tok3);
+
+                    // not part of template.. go on to next token
+                    else
+                        continue;
+
+                    // skip the code that is copied
+                    int indentlevel = 0;
+                    int parlevel = 0;
+                    for (; tok3; tok3 = tok3->next())
+                    {
+                        if (tok3->str() == "{")
+                            ++indentlevel;
+                        else if (tok3->str() == "}")
+                        {
+                            if (indentlevel <= 1 && parlevel == 0)
+                                break;
+                            --indentlevel;
+                        }
+                        else if (tok3->str() == "(" || tok3->str() == "[")
+                            ++parlevel;
+                        else if (tok3->str() == ")" || tok3->str() == "]")
+                            --parlevel;
+                    }
+                    if (!tok3)
+                        break;
+                }
+            }
+
             // Copy template..
-            int _indentlevel = 0;
-            int _parlevel = 0;
-            for (const Token *tok3 = _tokens; tok3; tok3 = tok3->next())
+            for (std::vector<const Token *>::const_iterator part = templateParts.begin(); part != templateParts.end(); ++part)
             {
-                if (tok3->str() == "{")
-                    ++_indentlevel;
-                else if (tok3->str() == "}")
-                    --_indentlevel;
-                else if (tok3->str() == "(")
-                    ++_parlevel;
-                else if (tok3->str() == ")")
-                    --_parlevel;
+                const Token *tok3 = *part;
 
                 // Start of template..
                 if (tok3 == tok)
@@ -3117,19 +3205,13 @@ void Tokenizer::simplifyTemplatesInstantiate(const Token *tok,
                 }
 
                 // member function implemented outside class definition
-                else if (_indentlevel == 0 &&
-                         _parlevel == 0 &&
-                         simplifyTemplatesInstantiateMatch(tok3, name, type.size(), ":: ~| %var% ("))
+                else
                 {
                     addtoken(name2.c_str(), tok3->linenr(), tok3->fileIndex());
                     while (tok3->str() != "::")
                         tok3 = tok3->next();
                 }
 
-                // not part of template.. go on to next token
-                else
-                    continue;
-
                 int indentlevel = 0;
                 std::stack<Token *> braces;     // holds "{" tokens
                 std::stack<Token *> brackets;   // holds "(" tokens
@@ -3178,7 +3260,7 @@ void Tokenizer::simplifyTemplatesInstantiate(const Token *tok,
                     }
 
                     // replace name..
-                    if (Token::Match(tok3, (name + " !!<").c_str()))
+                    if (Token::Match(tok3, nameNotTemplatePattern.c_str()))
                     {
                         addtoken(name2.c_str(), tok3->linenr(), tok3->fileIndex());
                         continue;
@@ -3188,7 +3270,7 @@ void Tokenizer::simplifyTemplatesInstantiate(const Token *tok,
                     addtoken(tok3, tok3->linenr(), tok3->fileIndex());
                     if (Token::Match(tok3, "%type% <"))
                     {
-                        if (!Token::Match(tok3, (name + " <").c_str()))
+                        if (!Token::simpleMatch(tok3, namePattern.c_str()))
                             done = false;
                         used.push_back(_tokensBack);
                     }
@@ -6521,6 +6603,34 @@ bool Tokenizer::simplifyKnownVariables()
         if (! Token::Match(tok, ") const| {"))
             continue;
 
+        // count how many times each variable is used in the block of code.
+        // assignments to variables that are not used anywhere else don't
+        // need to be simplified, so the rescan of the block can be skipped
+        std::map<unsigned int, unsigned int> varUsage;
+        {
+            int indentlevel = 0;
+            for (const Token *tok2 = tok; tok2; tok2 = tok2->next())
+            {
+                if (tok2->str() == "{")
+                    ++indentlevel;
+                else if (tok2->str() == "}")
+                {
+                    --indentlevel;
+                    if (indentlevel <= 0)
+                        break;
+                }
+                else if (tok2->varId() &&
+                         !(tok2->previous()->isStandardType() && tok2->next()->str() == ";"))
+                {
+                    ++varUsage[tok2->varId()];
+                }
+            }
+        }
+
+        // variable ids that have been used as values. These might get more
+        // usages when the simplifications are made.
+        std::set<unsigned int> valueVarIds;
+
         // parse the block of code..
         int indentlevel = 0;
         Token *tok2 = tok;
@@ -6574,6 +6684,10 @@ bool Tokenizer::simplifyKnownVariables()
                 if (tok2->str() == tok2->strAt(2))
                     continue;
 
+                // the variable is not used after the assignment
+                if (varUsage[varid] <= 1 && valueVarIds.find(varid) == valueVarIds.end())
+                    continue;
+
                 const Token * const valueToken = tok2->tokAt(2);
 
                 std::string value;
@@ -6585,6 +6699,9 @@ bool Tokenizer::simplifyKnownVariables()
                 if (!simplifyKnownVariablesGetData(varid, &tok2, &tok3, value, valueVarId, valueIsPointer, floatvars.find(tok2->varId()) != floatvars.end()))
                     continue;
 
+                if (valueVarId)
+                    valueVarIds.insert(valueVarId);
+
                 ret |= simplifyKnownVariablesSimplify(&tok2, tok3, varid, structname, value, valueVarId, valueIsPointer, valueToken, indentlevel);
             }
 
@@ -6697,6 +6814,22 @@ bool Tokenizer::simplifyKnownVariablesSimplify(Token **tok2, Token *tok3, unsign
 {
     const bool pointeralias(valueToken->isName() || Token::Match(valueToken, "& %var% ["));
 
+    // Patterns that are used for every token below. Build them once.
+    const std::string ifCondPattern("if ( " + structname + " %varid% ==|!=|<|<=|>|>=|)");
+    const std::string condPattern("( " + structname + " %varid% ==|!=|<|<=|>|>=");
+    const std::string comparePattern("!|==|!=|<|<=|>|>= " + structname + " %varid% ==|!=|<|<=|>|>=|)|;");
+    const std::string funcPar1Pattern("%var% ( " + structname + " %varid% ,");
+    const std::string funcPar2Pattern("%var% ( %any% , " + structname + " %varid% ,|)");
+    const std::string arrayPattern("[(,] " + structname + " %varid% [|%op%");
+    const std::string addressPattern("& " + structname + " %varid%");
+    const std::string calcPattern1("[=+-*/%^|[] " + structname + " %varid% [=?+-*/%^|;])]");
+    const std::string calcPattern2("[(=+-*/%^|[] " + structname + " %varid% <<|>>");
+    const std::string calcPattern3("<<|>> " + structname + " %varid% %op%|;|]|)");
+    const std::string calcPattern4("[=+-*/%^|[] ( " + structname + " %varid%");
+
+    // the value might be changed by "++" and "--" below
+    std::string pointerAliasPattern("!!= " + value);
+
     bool ret = false;
 
     Token* bailOutFromLoop = 0;
@@ -6735,7 +6868,7 @@ bool Tokenizer::simplifyKnownVariablesSimplify(Token **tok2, Token *tok3, unsign
         if (ret3 && tok3->str() == ";")
             break;
 
-        if (pointeralias && Token::Match(tok3, ("!!= " + value).c_str()))
+        if (pointeralias && Token::Match(tok3, pointerAliasPattern.c_str()))
             break;
 
         // Stop if do is found
@@ -6864,9 +6997,9 @@ bool Tokenizer::simplifyKnownVariablesSimplify(Token **tok2, Token *tok3, unsign
         }
 
         // Using the variable in condition..
-        if (Token::Match(tok3->previous(), ("if ( " + structname + " %varid% ==|!=|<|<=|>|>=|)").c_str(), varid) ||
-            Token::Match(tok3, ("( " + structname + " %varid% ==|!=|<|<=|>|>=").c_str(), varid) ||
-            Token::Match(tok3, ("!|==|!=|<|<=|>|>= " + structname + " %varid% ==|!=|<|<=|>|>=|)|;").c_str(), varid) ||
+        if (Token::Match(tok3->previous(), ifCondPattern.c_str(), varid) ||
+            Token::Match(tok3, condPattern.c_str(), varid) ||
+            Token::Match(tok3, comparePattern.c_str(), varid) ||
             Token::Match(tok3->previous(), "strlen|free ( %varid% )", varid))
         {
             if (value[0] == '\"' && tok3->strAt(-1) != "strlen")
@@ -6903,7 +7036,7 @@ bool Tokenizer::simplifyKnownVariablesSimplify(Token **tok2, Token *tok3, unsign
         }
 
         // Variable is used in function call..
-        if (Token::Match(tok3, ("%var% ( " + structname + " %varid% ,").c_str(), varid))
+        if (Token::Match(tok3, funcPar1Pattern.c_str(), varid))
         {
             const char * const functionName[] =
             {
@@ -6928,7 +7061,7 @@ bool Tokenizer::simplifyKnownVariablesSimplify(Token **tok2, Token *tok3, unsign
         }
 
         // Variable is used as 2nd parameter in function call..
-        if (Token::Match(tok3, ("%var% ( %any% , " + structname + " %varid% ,|)").c_str(), varid))
+        if (Token::Match(tok3, funcPar2Pattern.c_str(), varid))
         {
             const char * const functionName[] =
             {
@@ -6953,7 +7086,7 @@ bool Tokenizer::simplifyKnownVariablesSimplify(Token **tok2, Token *tok3, unsign
         }
 
         // array usage
-        if (Token::Match(tok3, ("[(,] " + structname + " %varid% [|%op%").c_str(), varid))
+        if (Token::Match(tok3, arrayPattern.c_str(), varid))
         {
             if (!structname.empty())
             {
@@ -6967,11 +7100,11 @@ bool Tokenizer::simplifyKnownVariablesSimplify(Token **tok2, Token *tok3, unsign
         }
 
         // Variable is used in calculation..
-        if (((tok3->previous()->varId() > 0) && Token::Match(tok3, ("& " + structname + " %varid%").c_str(), varid)) ||
-            Token::Match(tok3, ("[=+-*/%^|[] " + structname + " %varid% [=?+-*/%^|;])]").c_str(), varid) ||
-            Token::Match(tok3, ("[(=+-*/%^|[] " + structname + " %varid% <<|>>").c_str(), varid) ||
-            Token::Match(tok3, ("<<|>> " + structname + " %varid% %op%|;|]|)").c_str(), varid) ||
-            Token::Match(tok3->previous(), ("[=+-*/%^|[] ( " + structname + " %varid%").c_str(), varid))
+        if (((tok3->previous()->varId() > 0) && Token::Match(tok3, addressPattern.c_str(), varid)) ||
+            Token::Match(tok3, calcPattern1.c_str(), varid) ||
+            Token::Match(tok3, calcPattern2.c_str(), varid) ||
+            Token::Match(tok3, calcPattern3.c_str(), varid) ||
+            Token::Match(tok3->previous(), calcPattern4.c_str(), varid))
         {
             if (value[0] == '\"')
                 break;
@@ -7061,6 +7194,7 @@ bool Tokenizer::simplifyKnownVariablesSimplify(Token **tok2, Token *tok3, unsign
                 tok3->deleteNext();
             }
             incdec(value, op);
+            pointerAliasPattern = "!!= " + value;
             if (!Token::simpleMatch((*tok2)->tokAt(-2), "for ("))
             {
                 (*tok2)->tokAt(2)->str(value);
@@ -7073,6 +7207,7 @@ bool Tokenizer::simplifyKnownVariablesSimplify(Token **tok2, Token *tok3, unsign
             !Token::Match(tok3->tokAt(3), "[.[]"))
         {
             incdec(value, tok3->strAt(1));
+            pointerAliasPattern = "!!= " + value;
             (*tok2)->tokAt(2)->str(value);
             (*tok2)->tokAt(2)->varId(valueVarId);
             if (Token::Match(tok3, "[;{}] %any% %any% ;"))
@@ -7849,6 +7984,11 @@ void Tokenizer::simplifyEnum()
     if (isJavaOrCSharp())
         return;
 
+    // number of occurrences of each name. Enumerators that are not used
+    // anywhere don't need to be searched for.
+    std::map<std::string, unsigned int> names;
+    countNames(_tokens, names);
+
     std::string className;
     int classLevel = 0;
     for (Token *tok = _tokens; tok; tok = tok->next())
@@ -8041,7 +8181,8 @@ void Tokenizer::simplifyEnum()
                 }
 
                 // find all uses of this enumerator and substitute it's value for it's name
-                if (enumName && (enumValue || (enumValueStart && enumValueEnd)))
+                if (enumName && (enumValue || (enumValueStart && enumValueEnd)) &&
+                    names[enumName->str()] > 1)
                 {
                     const std::string pattern = className.empty() ?
                                                 std::string("") :
@@ -106,6 +106,7 @@ private:
         TEST_CASE(array_index_30); // ticket #2086 - out of bounds when type is unknown
         TEST_CASE(array_index_31); // ticket #2120 - out of bounds in subfunction when type is unknown
         TEST_CASE(array_index_32);
+        TEST_CASE(array_index_33); // the same function is called with different arrays
         TEST_CASE(array_index_multidim);
         TEST_CASE(array_index_switch_in_for);
         TEST_CASE(array_index_for_in_for);   // FP: #2634
@@ -117,6 +118,7 @@ private:
         TEST_CASE(array_index_for);        // FN: for,if
         TEST_CASE(array_index_for_neq);    // #2211: Using != in condition
         TEST_CASE(array_index_for_question);	// #2561: for, ?:
+        TEST_CASE(array_index_several_arrays);
 
         TEST_CASE(buffer_overrun_1);
         TEST_CASE(buffer_overrun_2);
@@ -1059,6 +1061,25 @@ private:
         TODO_ASSERT_EQUALS("[test.cpp:7]: (error) Array 'm_x[1]' index 1 out of bounds\n","", errout.str());
     }
 
+    void array_index_33()
+    {
+        check("void foo(int x, char *p)\n"
+              "{\n"
+              "    p[20] = 0;\n"
+              "}\n"
+              "void f()\n"
+              "{\n"
+              "    char a[10];\n"
+              "    char b[30];\n"
+              "    char c[5];\n"
+              "    foo(1, a);\n"
+              "    foo(2, b);\n"
+              "    foo(3, c);\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:10] -> [test.cpp:3]: (error) Array 'a[10]' index 20 out of bounds\n"
+                      "[test.cpp:12] -> [test.cpp:3]: (error) Array 'c[5]' index 20 out of bounds\n", errout.str());
+    }
+
     void array_index_multidim()
     {
         check("void f()\n"
@@ -1381,6 +1402,23 @@ private:
         ASSERT_EQUALS("", errout.str());
     }
 
+    void array_index_several_arrays()
+    {
+        // Each array is checked until its scope ends or a loop stops the checking
+        check("void bar(int x, char *p) { p[20] = 0; }\n"
+              "void f(int n)\n"
+              "{\n"
+              "    char a[10];\n"
+              "    char b[10];\n"
+              "    bar(n, b);\n"
+              "    a[10] = 0;\n"
+              "    for (int i = 0; i < 10; i++) { i++; }\n"
+              "    b[10] = 0;\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:7]: (error) Array 'a[10]' index 10 out of bounds\n"
+                      "[test.cpp:6] -> [test.cpp:1]: (error) Array 'b[10]' index 20 out of bounds\n", errout.str());
+    }
+
     void buffer_overrun_1()
     {
         check("void f()\n"
@@ -73,6 +73,10 @@ private:
         TEST_CASE(jobs);
         TEST_CASE(jobsMissingCount);
         TEST_CASE(jobsInvalid);
+        TEST_CASE(analysisFile);
+        TEST_CASE(cacheFile);
+        TEST_CASE(costFile);
+        TEST_CASE(progressFile);
         TEST_CASE(reportProgress);
         TEST_CASE(suppressionsOld); // TODO: Create and test real suppression file
         TEST_CASE(suppressions)
@@ -89,6 +93,7 @@ private:
         TEST_CASE(xmlver2both2);
         TEST_CASE(xmlverunknown);
         TEST_CASE(xmlverinvalid);
+        TEST_CASE(json);
         TEST_CASE(errorlist1);
         TEST_CASE(errorlistverbose1)
         TEST_CASE(errorlistverbose2)
@@ -517,6 +522,46 @@ private:
         ASSERT(!parser.ParseFromArgs(4, argv));
     }
 
+    void analysisFile()
+    {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--analysis-file=analysis.txt", "file.cpp"};
+        Settings settings;
+        CmdLineParser parser(&settings);
+        ASSERT(parser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS("analysis.txt", settings.analysisFile);
+    }
+
+    void cacheFile()
+    {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--cache-file=results.cache", "file.cpp"};
+        Settings settings;
+        CmdLineParser parser(&settings);
+        ASSERT(parser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS("results.cache", settings.cacheFile);
+    }
+
+    void costFile()
+    {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--cost-file=cost.txt", "file.cpp"};
+        Settings settings;
+        CmdLineParser parser(&settings);
+        ASSERT(parser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS("cost.txt", settings.costFile);
+    }
+
+    void progressFile()
+    {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--progress-file=progress.json", "file.cpp"};
+        Settings settings;
+        CmdLineParser parser(&settings);
+        ASSERT(parser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS("progress.json", settings.progressFile);
+    }
+
     void reportProgress()
     {
         REDIRECT;
@@ -679,6 +724,17 @@ private:
         ASSERT(!parser.ParseFromArgs(4, argv));
     }
 
+    void json()
+    {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--json", "file.cpp"};
+        Settings settings;
+        CmdLineParser parser(&settings);
+        ASSERT(parser.ParseFromArgs(3, argv));
+        ASSERT(settings._json);
+        ASSERT(!settings._xml);
+    }
+
     void errorlist1()
     {
         REDIRECT;
@@ -27,6 +27,8 @@
 #include "path.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include <string>
 #include <stdexcept>
@@ -49,6 +51,7 @@ private:
     {
     public:
         std::list<std::string> id;
+        std::list<std::string> errors;
 
         void reportOut(const std::string & /*outmsg*/)
         {
@@ -57,6 +60,7 @@ private:
         void reportErr(const ErrorLogger::ErrorMessage &msg)
         {
             id.push_back(msg._id);
+            errors.push_back(msg.toString(false));
         }
 
         void reportStatus(unsigned int /*fileindex*/, unsigned int /*filecount*/, long /*sizedone*/, long /*sizetotal*/)
@@ -68,6 +72,11 @@ private:
     {
         TEST_CASE(instancesSorted);
         TEST_CASE(getErrorMessages);
+        TEST_CASE(checkJobs);
+        TEST_CASE(checkJobsFunctions);
+        TEST_CASE(resultsCache);
+        TEST_CASE(resultsCacheAnalysisData);
+        TEST_CASE(analysisFile);
     }
 
     void instancesSorted()
@@ -104,6 +113,217 @@ private:
         }
         ASSERT_EQUALS("", duplicate);
     }
+
+    void checkJobs()
+    {
+        const char code[] = "void f()\n"
+                            "{\n"
+                            "    char *p = malloc(10);\n"
+                            "    char a[10];\n"
+                            "    a[10] = 0;\n"
+                            "    int *q = 0;\n"
+                            "    *q = 0;\n"
+                            "}\n";
+
+        ErrorLogger2 serial;
+        CppCheck cppCheck1(serial, false);
+        cppCheck1.check("test.cpp", code);
+
+        ErrorLogger2 parallel;
+        CppCheck cppCheck2(parallel, false);
+        cppCheck2.settings()._checkJobs = 3;
+        cppCheck2.check("test.cpp", code);
+
+        ASSERT(!serial.id.empty());
+        ASSERT_EQUALS(true, serial.id == parallel.id);
+    }
+
+    void checkJobsFunctions()
+    {
+        // Enough functions for the execution path checks to check the
+        // function bodies in parallel
+        std::ostringstream code;
+        for (unsigned int i = 0; i < 12; ++i)
+        {
+            code << "void f" << i << "()\n"
+                 << "{\n"
+                 << "    int x;\n"
+                 << "    int *p = 0;\n"
+                 << "    char a[10];\n"
+                 << "    a[" << (10 + i) << "] = x;\n"
+                 << "    *p = 0;\n"
+                 << "}\n";
+        }
+
+        ErrorLogger2 serial;
+        CppCheck cppCheck1(serial, false);
+        cppCheck1.check("test.cpp", code.str());
+        ASSERT_EQUALS(36U, serial.errors.size());
+
+        // With 2 processes the function bodies are checked in parallel, with
+        // more the checks are run in parallel and the processes that are
+        // left are used for the function bodies
+        for (unsigned int jobs = 2; jobs <= 5; ++jobs)
+        {
+            ErrorLogger2 parallel;
+            CppCheck cppCheck2(parallel, false);
+            cppCheck2.settings()._checkJobs = jobs;
+            cppCheck2.check("test.cpp", code.str());
+            ASSERT_EQUALS(true, serial.errors == parallel.errors);
+        }
+    }
+
+    void resultsCache()
+    {
+        const char code[] = "void f()\n"
+                            "{\n"
+                            "    char a[10];\n"
+                            "    a[10] = 0;\n"
+                            "}\n";
+
+        Settings settings;
+        settings.cacheFile = "cppcheck.cache";
+
+        ErrorLogger2 first;
+        CppCheck cppCheck1(first, false);
+        cppCheck1.settings(settings);
+        cppCheck1.check("resultsCache.cpp", code);
+        ASSERT(!cppCheck1.resultsFromCache());
+        ASSERT_EQUALS(1U, first.id.size());
+        ASSERT_EQUALS("arrayIndexOutOfBounds", first.id.front());
+
+        // Change the id in the cache to see that the message comes from there
+        std::string data;
+        ASSERT(CppCheck::getCachedResults("resultsCache.cpp", data));
+        const std::string::size_type pos = data.find("arrayIndexOutOfBounds");
+        ASSERT(pos != std::string::npos);
+        data.replace(pos, 21, "cachedIndexOutOfBound");
+
+        // Write the cache and read it back
+        CppCheck::setCachedResults("resultsCache.cpp", data);
+        std::ostringstream ostr;
+        CppCheck::writeResultsCache(ostr, settings);
+        CppCheck::setCachedResults("resultsCache.cpp", "");
+        std::istringstream istr(ostr.str());
+        CppCheck::readResultsCache(istr, settings);
+
+        ErrorLogger2 second;
+        CppCheck cppCheck2(second, false);
+        cppCheck2.settings(settings);
+        cppCheck2.check("resultsCache.cpp", code);
+        ASSERT(cppCheck2.resultsFromCache());
+        ASSERT_EQUALS(1U, second.id.size());
+        ASSERT_EQUALS("cachedIndexOutOfBound", second.id.front());
+
+        // The file is checked again when it has changed
+        ErrorLogger2 third;
+        CppCheck cppCheck3(third, false);
+        cppCheck3.settings(settings);
+        cppCheck3.check("resultsCache.cpp", std::string(code) + "\n");
+        ASSERT_EQUALS(1U, third.id.size());
+        ASSERT_EQUALS("arrayIndexOutOfBounds", third.id.front());
+
+        // The cache is not read if the settings are different
+        settings.inconclusive = true;
+        std::istringstream istr2(ostr.str());
+        CppCheck::setCachedResults("resultsCache.cpp", "");
+        CppCheck::readResultsCache(istr2, settings);
+        ASSERT(CppCheck::getCachedResults("resultsCache.cpp", data));
+        ASSERT_EQUALS("", data);
+
+        // A corrupt length is not trusted
+        std::istringstream istr3("4000000000 cppcheck");
+        CppCheck::readResultsCache(istr3, settings);
+
+        // The results are not cached when unused functions are checked
+        Settings settings2;
+        settings2.cacheFile = "cppcheck.cache";
+        settings2.addEnabled("unusedFunction");
+        ErrorLogger2 fourth;
+        CppCheck cppCheck4(fourth, false);
+        cppCheck4.settings(settings2);
+        cppCheck4.check("unusedFunction.cpp", code);
+        ASSERT(!CppCheck::getCachedResults("unusedFunction.cpp", data));
+    }
+
+    void resultsCacheAnalysisData()
+    {
+        const char code[] = "void g()\n"
+                            "{\n"
+                            "    int x;\n"
+                            "    cachedAnalysisFunction(x);\n"
+                            "}\n";
+
+        Settings settings;
+        settings.cacheFile = "cppcheck.cache";
+
+        ErrorLogger2 first;
+        CppCheck cppCheck1(first, false);
+        cppCheck1.settings(settings);
+        cppCheck1.check("resultsCacheB.c", code);
+        ASSERT_EQUALS(0U, first.id.size());
+
+        // The function is analysed when another file is checked
+        ErrorLogger2 other;
+        CppCheck cppCheck2(other, false);
+        cppCheck2.settings(settings);
+        cppCheck2.check("resultsCacheA.c", "void cachedAnalysisFunction(int x)\n{\n    x;\n}\n");
+        std::string data;
+        ASSERT(CppCheck::getCachedResults("resultsCacheA.c", data));
+        ASSERT(data.find("cachedAnalysisFunction") != std::string::npos);
+
+        // The first file is checked again because the analysis data has changed
+        ErrorLogger2 second;
+        CppCheck cppCheck3(second, false);
+        cppCheck3.settings(settings);
+        cppCheck3.check("resultsCacheB.c", code);
+        ASSERT_EQUALS(1U, second.id.size());
+        ASSERT_EQUALS("uninitvar", second.id.front());
+    }
+
+    void analysisFile()
+    {
+        const char filename[] = "analysisFile.c";
+        {
+            std::ofstream fout(filename);
+            fout << "void analysisFileFunction(int x)\n{\n    x;\n}\n";
+        }
+
+        Settings settings;
+        settings.analysisFile = "cppcheck.analysis";
+
+        ErrorLogger2 errorLogger;
+        CppCheck cppCheck(errorLogger, false);
+        cppCheck.settings(settings);
+        cppCheck.check(filename);
+
+        std::string data;
+        ASSERT(CppCheck::getFileAnalysisData(filename, data));
+        ASSERT(data.find("analysisFileFunction") != std::string::npos);
+
+        // The data is read back if the file has not changed
+        std::ostringstream ostr;
+        CppCheck::writeAnalysisFile(ostr);
+        CppCheck::setFileAnalysisData(filename, "");
+        std::istringstream istr(ostr.str());
+        CppCheck::readAnalysisFile(istr);
+        std::string data2;
+        ASSERT(CppCheck::getFileAnalysisData(filename, data2));
+        ASSERT_EQUALS(data, data2);
+
+        // The data is dropped if the file has changed
+        {
+            std::ofstream fout(filename);
+            fout << "void analysisFileFunction(int *x)\n{\n}\n";
+        }
+        CppCheck::setFileAnalysisData(filename, "");
+        std::istringstream istr2(ostr.str());
+        CppCheck::readAnalysisFile(istr2);
+        ASSERT(CppCheck::getFileAnalysisData(filename, data2));
+        ASSERT_EQUALS("", data2);
+
+        std::remove(filename);
+    }
 };
 
 REGISTER_TEST(TestCppcheck)
@@ -37,9 +37,12 @@ private:
         TEST_CASE(ErrorMessageVerbose);
         TEST_CASE(CustomFormat);
         TEST_CASE(CustomFormat2);
+        TEST_CASE(CustomFormat3);
         TEST_CASE(ToXml);
         TEST_CASE(ToVerboseXml);
         TEST_CASE(ToXmlV2);
+        TEST_CASE(ToXmlEscape);
+        TEST_CASE(ToJson);
 
         // Inconclusive results in xml reports..
         TEST_CASE(InconclusiveXml);
@@ -123,6 +126,27 @@ private:
         ASSERT_EQUALS("Verbose error - foo.cpp(5):(error,errorId)", msg.toString(true, "{message} - {file}({line}):({severity},{id})"));
     }
 
+    void CustomFormat3()
+    {
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs;
+        locs.push_back(ErrorLogger::ErrorMessage::FileLocation("foo.cpp", 5));
+        ErrorMessage msg(locs, Severity::error, "Programming error.", "errorId", false);
+
+        // Braces that are not fields are written as they are
+        ASSERT_EQUALS("{{foo.cpp}} {x}foo.cpp}{5{", msg.toString(false, "{{{file}}} {x}{file}}{{line}{"));
+
+        // No location
+        ErrorMessage msg2(std::list<ErrorLogger::ErrorMessage::FileLocation>(), Severity::error, "Programming error.", "errorId", false);
+        ASSERT_EQUALS(":,errorId", msg2.toString(false, "{file}:{line},{id}"));
+
+        // The parsed template is used for several messages
+        const ErrorLogger::ErrorMessage::Template outputFormat("{id}:{line}\n");
+        std::string out;
+        msg.writeString(out, false, outputFormat);
+        msg2.writeString(out, false, outputFormat);
+        ASSERT_EQUALS("errorId:5\nerrorId:\n", out);
+    }
+
     void ToXml()
     {
         ErrorLogger::ErrorMessage::FileLocation loc;
@@ -169,6 +193,33 @@ private:
         ASSERT_EQUALS(message, msg.toXML(false,2));
     }
 
+    void ToXmlEscape()
+    {
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs;
+        locs.push_back(ErrorLogger::ErrorMessage::FileLocation("a&b.cpp", 5));
+        ErrorMessage msg(locs, Severity::style, "Use \"<\" and \">\".\nFirst line\nSecond line", "errorId", false);
+        ASSERT_EQUALS("<error file=\"a&amp;b.cpp\" line=\"5\" id=\"errorId\" severity=\"style\" msg=\"Use &quot;&lt;&quot; and &quot;&gt;&quot;.\"/>", msg.toXML(false,1));
+        ASSERT_EQUALS("<error file=\"a&amp;b.cpp\" line=\"5\" id=\"errorId\" severity=\"style\" msg=\"First line&#xa;Second line\"/>", msg.toXML(true,1));
+
+        // The XML is appended to the given string
+        std::string out("x");
+        msg.writeXML(out, false, 1);
+        ASSERT_EQUALS("x" + msg.toXML(false,1), out);
+    }
+
+    void ToJson()
+    {
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs;
+        locs.push_back(ErrorLogger::ErrorMessage::FileLocation("foo.cpp", 10));
+        locs.push_back(ErrorLogger::ErrorMessage::FileLocation("bar\"x\".h", 5));
+        ErrorMessage msg(locs, Severity::error, "Programming error.\nVerbose\terror\\\n\x01", "errorId", true);
+        std::string out;
+        msg.writeJSON(out);
+        ASSERT_EQUALS("{\"id\":\"errorId\",\"severity\":\"error\",\"inconclusive\":true,"
+                      "\"msg\":\"Programming error.\",\"verbose\":\"Verbose\\terror\\\\\\n\\u0001\","
+                      "\"locations\":[{\"file\":\"bar\\\"x\\\".h\",\"line\":5},{\"file\":\"foo.cpp\",\"line\":10}]}", out);
+    }
+
     void InconclusiveXml()
     {
         // Location
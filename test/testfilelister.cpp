@@ -18,8 +18,10 @@
 
 #include "testsuite.h"
 #include "filelister.h"
+#include "pathmatch.h"
 #include <fstream>
 #include <algorithm>
+#include <functional>
 
 class TestFileLister: public TestFixture
 {
@@ -40,6 +42,8 @@ private:
 
         TEST_CASE(isDirectory);
         TEST_CASE(recursiveAddFiles);
+        TEST_CASE(recursiveAddFilesTrailingSlash);
+        TEST_CASE(recursiveAddFilesIgnored);
     }
 
     void isDirectory()
@@ -77,6 +81,41 @@ private:
         // Make sure headers are not added..
         ASSERT(std::find(filenames.begin(), filenames.end(), "lib/tokenize.h") == filenames.end());
     }
+
+    void recursiveAddFilesTrailingSlash()
+    {
+        std::vector<std::string> filenames1, filenames2;
+        std::map<std::string, long> filesizes;
+        FileLister::recursiveAddFiles(filenames1, filesizes, "lib");
+        FileLister::recursiveAddFiles(filenames2, filesizes, "lib//");
+
+        // Same files, in the same order, without double slashes
+        ASSERT(!filenames1.empty());
+        ASSERT(filenames1 == filenames2);
+        ASSERT(std::find(filenames1.begin(), filenames1.end(), "lib/token.cpp") != filenames1.end());
+
+        // Files are sorted and not added twice
+        ASSERT(std::adjacent_find(filenames1.begin(), filenames1.end(), std::greater_equal<std::string>()) == filenames1.end());
+    }
+
+    void recursiveAddFilesIgnored()
+    {
+        std::vector<std::string> masks;
+        masks.push_back("lib/");
+        PathMatch ignored(masks);
+
+        // Ignored directories are not walked
+        std::vector<std::string> filenames;
+        std::map<std::string, long> filesizes;
+        FileLister::recursiveAddFiles(filenames, filesizes, "cli/../", ignored);
+        ASSERT(std::find(filenames.begin(), filenames.end(), "cli/../cli/main.cpp") != filenames.end());
+        ASSERT(std::find(filenames.begin(), filenames.end(), "cli/../lib/token.cpp") == filenames.end());
+
+        // The given directory is walked
+        filenames.clear();
+        FileLister::recursiveAddFiles(filenames, filesizes, "lib", ignored);
+        ASSERT(std::find(filenames.begin(), filenames.end(), "lib/token.cpp") != filenames.end());
+    }
 };
 
 REGISTER_TEST(TestFileLister)
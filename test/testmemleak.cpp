@@ -169,6 +169,7 @@ private:
         TEST_CASE(simple7);
         TEST_CASE(simple9);     // Bug 2435468 - member function "free"
         TEST_CASE(simple11);
+        TEST_CASE(simple12);    // only variables that are allocated/deallocated are checked
         TEST_CASE(new_nothrow);
 
         TEST_CASE(staticvar);
@@ -232,6 +233,7 @@ private:
         TEST_CASE(func22);      // Ticket #2668
         TEST_CASE(func23);      // Ticket #2667
         TEST_CASE(func24);      // Ticket #2705
+        TEST_CASE(func25);      // same function is called several times
 
         TEST_CASE(allocfunc1);
         TEST_CASE(allocfunc2);
@@ -908,6 +910,32 @@ private:
 
 
 
+    void simple12()
+    {
+        check("void f(char *a, int *b)\n"
+              "{\n"
+              "    char *p = malloc(10);\n"
+              "    char *q;\n"
+              "    int *r;\n"
+              "    *a = 0;\n"
+              "    if (b)\n"
+              "        *b = 0;\n"
+              "    q = &a[1];\n"
+              "    r = new int;\n"
+              "    delete r;\n"
+              "    delete r;\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:13]: (error) Memory leak: p\n"
+                      "[test.cpp:12]: (error) Deallocating a deallocated pointer: r\n", errout.str());
+
+        check("void f(char *a)\n"
+              "{\n"
+              "    free(a);\n"
+              "    a[0] = 0;\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:4]: (error) Dereferencing 'a' after it is deallocated / released\n", errout.str());
+    }
+
     void new_nothrow()
     {
         check("void f()\n"
@@ -2204,6 +2232,40 @@ private:
         ASSERT_EQUALS("", errout.str());
     }
 
+    void func25()
+    {
+        check("static void foo(char *str)\n"
+              "{\n"
+              "    delete str;\n"
+              "}\n"
+              "\n"
+              "static void f()\n"
+              "{\n"
+              "    char *p = new char[100];\n"
+              "    foo(p);\n"
+              "    char *q = new char[100];\n"
+              "    foo(q);\n"
+              "}\n", true);
+        ASSERT_EQUALS("[test.cpp:9] -> [test.cpp:3]: (error) Mismatching allocation and deallocation: str\n"
+                      "[test.cpp:11] -> [test.cpp:3]: (error) Mismatching allocation and deallocation: str\n",
+                      errout.str());
+
+        check("static void release(char *str)\n"
+              "{\n"
+              "    free(str);\n"
+              "}\n"
+              "\n"
+              "static void f()\n"
+              "{\n"
+              "    char *p = malloc(10);\n"
+              "    release(p);\n"
+              "    char *q = malloc(10);\n"
+              "    release(q);\n"
+              "    char *r = malloc(10);\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:13]: (error) Memory leak: r\n", errout.str());
+    }
+
     void allocfunc1()
     {
         check("static char *a()\n"
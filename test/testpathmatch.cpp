@@ -45,6 +45,10 @@ private:
         TEST_CASE(onemasklongerpath1);
         TEST_CASE(onemasklongerpath2);
         TEST_CASE(onemasklongerpath3);
+        TEST_CASE(twomaskdirfile1);
+        TEST_CASE(twomaskdirfile2);
+        TEST_CASE(dirmaskpath1);
+        TEST_CASE(dirmaskpath2);
         TEST_CASE(filemask1);
         TEST_CASE(filemask2);
         TEST_CASE(filemask3);
@@ -198,6 +202,47 @@ private:
         ASSERT(match.Match("project/src/module/"));
     }
 
+    void twomaskdirfile1()
+    {
+        std::vector<std::string> masks;
+        masks.push_back("src/");
+        masks.push_back("foo.cpp");
+        PathMatch match(masks);
+        ASSERT(match.Match("project/src/bar.cpp"));
+        ASSERT(match.Match("project/lib/foo.cpp"));
+        ASSERT(!match.Match("project/lib/bar.cpp"));
+    }
+
+    void twomaskdirfile2()
+    {
+        std::vector<std::string> masks;
+        masks.push_back("src/");
+        masks.push_back("");
+        PathMatch match(masks);
+        ASSERT(!match.Match("project/lib/bar.cpp"));
+    }
+
+    void dirmaskpath1()
+    {
+        std::vector<std::string> masks;
+        masks.push_back("src/module/");
+        PathMatch match(masks);
+        ASSERT(match.Match("src/module/foo.cpp"));
+        ASSERT(match.Match("project/src/module/"));
+        ASSERT(!match.Match("project/src/other/module/"));
+        ASSERT(!match.Match("project/mysrc/module/"));
+    }
+
+    void dirmaskpath2()
+    {
+        std::vector<std::string> masks;
+        masks.push_back("src/");
+        masks.push_back("src/module/");
+        PathMatch match(masks);
+        ASSERT(match.Match("project/src/foo.cpp"));
+        ASSERT(!match.Match("project/src"));
+    }
+
     void filemask1()
     {
         std::vector<std::string> masks;
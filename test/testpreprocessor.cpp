@@ -221,6 +221,9 @@ private:
 
         // inline suppression, missingInclude
         TEST_CASE(inline_suppression_for_missing_include);
+
+        // the paths where a missing include was searched for
+        TEST_CASE(missing_include_files);
     }
 
 
@@ -2845,6 +2848,25 @@ private:
         preprocessor.preprocess(src, processedFile, cfg, "test.c", paths);
         ASSERT_EQUALS("", errout.str());
     }
+
+    void missing_include_files()
+    {
+        Settings settings;
+        Preprocessor preprocessor(&settings, this);
+
+        std::istringstream src("#include \"missing.h\"\n"
+                               "int x;");
+        std::string processedFile;
+        std::list<std::string> cfg;
+        std::list<std::string> paths;
+        paths.push_back("inc/");
+
+        preprocessor.preprocess(src, processedFile, cfg, "src/test.c", paths);
+        std::string missing;
+        for (std::list<std::string>::const_iterator it = preprocessor.missingIncludeFiles().begin(); it != preprocessor.missingIncludeFiles().end(); ++it)
+            missing += *it + " ";
+        ASSERT_EQUALS("missing.h inc/missing.h src/missing.h ", missing);
+    }
 };
 
 REGISTER_TEST(TestPreprocessor)
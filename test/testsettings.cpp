@@ -37,6 +37,7 @@ private:
         TEST_CASE(suppressionsDosFormat);     // Ticket #1836
         TEST_CASE(suppressionsFileNameWithColon);    // Ticket #1919 - filename includes colon
         TEST_CASE(suppressionsGlob);
+        TEST_CASE(suppressionsUnmatched);
     }
 
     void suppressionsBadId1()
@@ -99,6 +100,35 @@ private:
             ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "abc.cpp", 2));
         }
     }
+
+    void suppressionsUnmatched()
+    {
+        Settings::Suppressions suppressions;
+        std::istringstream s("errorid:a.cpp:1\nerrorid:a.cpp:2\nerrorid:b*.cpp:3\nerrorid:b*.cpp:4\n");
+        ASSERT_EQUALS("", suppressions.parseFile(s));
+
+        ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "a.cpp", 2));
+        ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "b1.cpp", 4));
+        ASSERT_EQUALS(false, suppressions.isSuppressed("errorid", "b1.cpp", 5));
+
+        std::list<Settings::Suppressions::SuppressionEntry> unmatched = suppressions.getUnmatchedLocalSuppressions("a.cpp");
+        ASSERT_EQUALS(1U, unmatched.size());
+        ASSERT_EQUALS(1U, unmatched.front().line);
+        unmatched = suppressions.getUnmatchedGlobalSuppressions();
+        ASSERT_EQUALS(1U, unmatched.size());
+        ASSERT_EQUALS("b*.cpp", unmatched.front().file);
+        ASSERT_EQUALS(3U, unmatched.front().line);
+
+        // A glob that is added later is matched against files that have been seen
+        ASSERT_EQUALS("", suppressions.addSuppression("errorid", "*1.cpp", 5));
+        ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "b1.cpp", 5));
+
+        // Copies have their own matched state
+        Settings::Suppressions copy(suppressions);
+        ASSERT_EQUALS(true, copy.isSuppressed("errorid", "b2.cpp", 3));
+        ASSERT_EQUALS(0U, copy.getUnmatchedGlobalSuppressions().size());
+        ASSERT_EQUALS(1U, suppressions.getUnmatchedGlobalSuppressions().size());
+    }
 };
 
 REGISTER_TEST(TestSettings)
@@ -116,6 +116,7 @@ private:
         TEST_CASE(template23);
         TEST_CASE(template24);  // #2648 - using sizeof in template parameter
         TEST_CASE(template25);  // #2648 - another test for sizeof template parameter
+        TEST_CASE(template26);  // several instantiations, member function implemented outside class
         TEST_CASE(template_unhandled);
         TEST_CASE(template_default_parameter);
         TEST_CASE(template_default_type);
@@ -257,6 +258,7 @@ private:
         TEST_CASE(simplifyTypedef91); // ticket #2716
         TEST_CASE(simplifyTypedef92); // ticket #2736
         TEST_CASE(simplifyTypedef93); // ticket #2738
+        TEST_CASE(simplifyTypedef94); // unused typedefs
 
         TEST_CASE(simplifyTypedefFunction1);
         TEST_CASE(simplifyTypedefFunction2); // ticket #1685
@@ -305,6 +307,7 @@ private:
         TEST_CASE(enum20); // ticket #2600
         TEST_CASE(enum21); // ticket #2720
         TEST_CASE(enum22); // ticket #2745
+        TEST_CASE(enum23); // unused enumerators
 
         // remove "std::" on some standard functions
         TEST_CASE(removestd);
@@ -2094,6 +2097,24 @@ private:
 
     }
 
+    void template26()
+    {
+        const char code[] = "template <class T> class Fred { T f(); };\n"
+                            "template <class T> T Fred<T>::f() { return 0; }\n"
+                            "Fred<int> fred1;\n"
+                            "Fred<char> fred2;";
+
+        const std::string expected("; "
+                                   "Fred<int> fred1 ; "
+                                   "Fred<char> fred2 ; "
+                                   "class Fred<int> { int f ( ) ; } "
+                                   "Fred<int> :: f ( ) { return 0 ; } "
+                                   "class Fred<char> { char f ( ) ; } "
+                                   "Fred<char> :: f ( ) { return 0 ; }");
+
+        ASSERT_EQUALS(expected, sizeof_(code));
+    }
+
     void template_unhandled()
     {
         // An unhandled template usage should be simplified..
@@ -5240,6 +5261,19 @@ private:
         ASSERT_EQUALS("", errout.str());
     }
 
+    void simplifyTypedef94() // unused typedefs
+    {
+        const char code[] = "typedef int A;\n"
+                            "typedef unsigned char B, C;\n"
+                            "typedef struct { int x; } D;\n"
+                            "C c;\n";
+        const char expected[] = "; struct D { int x ; } ; char c ;";
+
+        checkSimplifyTypedef(code);
+        ASSERT_EQUALS(expected, sizeof_(code));
+        ASSERT_EQUALS("", errout.str());
+    }
+
     void simplifyTypedefFunction1()
     {
         {
@@ -6533,6 +6567,14 @@ private:
                       "[test.cpp:6] -> [test.cpp:1]: (style) Function parameter 'x' hides enumerator with same name\n", errout.str());
     }
 
+    void enum23() // unused enumerators
+    {
+        const char code[] = "enum A { a, b, c, d = 10, e };\n"
+                            "int x = e;\n";
+        const char expected[] = "; int x ; x = 11 ;";
+        ASSERT_EQUALS(expected, tok(code, false));
+    }
+
     void removestd()
     {
         ASSERT_EQUALS("; strcpy ( a , b ) ;", tok("; std::strcpy(a,b);"));
@@ -42,6 +42,7 @@ private:
         TEST_CASE(iterator6);
         TEST_CASE(iterator7);
         TEST_CASE(iterator8);
+        TEST_CASE(iterator9);
 
         TEST_CASE(dereference);
         TEST_CASE(dereference_member);
@@ -277,6 +278,35 @@ private:
         ASSERT_EQUALS("[test.cpp:8]: (error) Same iterator is used with both s1 and s2\n", errout.str());
     }
 
+    void iterator9()
+    {
+        // member iterator is used outside the class definition
+        check("class Fred {\n"
+              "    std::list<int> l1;\n"
+              "    std::list<int> l2;\n"
+              "    std::list<int>::iterator it;\n"
+              "    void f() { it = l1.begin(); }\n"
+              "    void g();\n"
+              "};\n"
+              "void Fred::g()\n"
+              "{\n"
+              "    l2.erase(it);\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:10]: (error) Same iterator is used with both l1 and l2\n", errout.str());
+
+        // local iterators in different functions
+        check("void f1(std::list<int> &l1)\n"
+              "{\n"
+              "    std::list<int>::iterator it = l1.begin();\n"
+              "}\n"
+              "void f2(std::list<int> &l2)\n"
+              "{\n"
+              "    std::list<int>::iterator it = l2.begin();\n"
+              "    l2.erase(it);\n"
+              "}\n");
+        ASSERT_EQUALS("", errout.str());
+    }
+
     // Dereferencing invalid pointer
     void dereference()
     {
@@ -27,6 +27,8 @@
 #include "cppcheckexecutor.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include <string>
 #include <stdexcept>
@@ -82,6 +84,12 @@ private:
         TEST_CASE(no_errors_equal_amount_files);
         TEST_CASE(one_error_less_files);
         TEST_CASE(one_error_several_files);
+        TEST_CASE(error_message);
+        TEST_CASE(analysis_data);
+        TEST_CASE(analysis_data_2_pass);
+        TEST_CASE(schedule_files);
+        TEST_CASE(cost_file);
+        TEST_CASE(progress);
     }
 
     void deadlock_with_many_errors()
@@ -142,6 +150,215 @@ private:
         oss << "}\n";
         check(2, 20, 20, oss.str());
     }
+
+    void error_message()
+    {
+        // The call stack and the file names are sent to the parent
+        std::map<std::string, std::string> contents;
+        contents["file_1.cpp"] = "static void memclr( char *data )\n"
+                                 "{\n"
+                                 "    data[10] = 0;\n"
+                                 "}\n"
+                                 "\n"
+                                 "static void f()\n"
+                                 "{\n"
+                                 "    char str[5];\n"
+                                 "    memclr( str );\n"
+                                 "}\n";
+        contents["file_2.cpp"] = "void f()\n"
+                                 "{\n"
+                                 "    char str[5];\n"
+                                 "    str[5] = 0;\n"
+                                 "}\n";
+        std::vector<std::string> filenames;
+        filenames.push_back("file_1.cpp");
+        filenames.push_back("file_2.cpp");
+        checkFunctionUse(1, false, filenames, contents);
+        ASSERT_EQUALS("[file_1.cpp:9] -> [file_1.cpp:3]: (error) Array 'str[5]' index 10 out of bounds\n"
+                      "[file_2.cpp:4]: (error) Array 'str[5]' index 5 out of bounds\n", errout.str());
+    }
+
+    /** Check the files with the given contents */
+    void checkFunctionUse(unsigned int jobs, bool test_2_pass, const std::vector<std::string> &filenames, const std::map<std::string, std::string> &contents)
+    {
+        errout.str("");
+        output.str("");
+        if (!ThreadExecutor::isEnabled())
+            return;
+
+        std::map<std::string, long> filesizes;
+        Settings settings;
+        settings._jobs = jobs;
+        settings.test_2_pass = test_2_pass;
+        ThreadExecutor executor(filenames, filesizes, settings, *this);
+        for (std::map<std::string, std::string>::const_iterator it = contents.begin(); it != contents.end(); ++it)
+            executor.addFileContent(it->first, it->second);
+        executor.check();
+    }
+
+    void analysis_data()
+    {
+        // The files are analysed before they are checked, so the result
+        // is the same as when the files are checked one by one
+        std::map<std::string, std::string> contents;
+        contents["file_1.cpp"] = "int threadexecutor1(int x)\n"
+                                 "{\n"
+                                 "    return x + 1;\n"
+                                 "}\n";
+        contents["file_2.cpp"] = "void f()\n"
+                                 "{\n"
+                                 "    int x;\n"
+                                 "    threadexecutor1(x);\n"
+                                 "}\n";
+        std::vector<std::string> filenames;
+        filenames.push_back("file_1.cpp");
+        filenames.push_back("file_2.cpp");
+        checkFunctionUse(2, false, filenames, contents);
+        ASSERT_EQUALS("[file_2.cpp:4]: (error) Uninitialized variable: x\n", errout.str());
+    }
+
+    void analysis_data_2_pass()
+    {
+        // All files are analysed before they are checked
+        std::map<std::string, std::string> contents;
+        contents["file_1.cpp"] = "void f()\n"
+                                 "{\n"
+                                 "    int x;\n"
+                                 "    threadexecutor2(x);\n"
+                                 "}\n";
+        contents["file_2.cpp"] = "int threadexecutor2(int x)\n"
+                                 "{\n"
+                                 "    return x + 1;\n"
+                                 "}\n";
+        std::vector<std::string> filenames;
+        filenames.push_back("file_1.cpp");
+        filenames.push_back("file_2.cpp");
+        checkFunctionUse(2, true, filenames, contents);
+        ASSERT_EQUALS("[file_1.cpp:4]: (error) Uninitialized variable: x\n", errout.str());
+    }
+
+    void schedule_files()
+    {
+        std::vector<std::string> filenames;
+        filenames.push_back("a.cpp");
+        filenames.push_back("b.cpp");
+        filenames.push_back("c.cpp");
+        filenames.push_back("d.cpp");
+
+        std::map<std::string, long> filesizes;
+        filesizes["a.cpp"] = 100;
+        filesizes["b.cpp"] = 300;
+        filesizes["c.cpp"] = 200;
+        filesizes["d.cpp"] = 200;
+
+        // No times are known, the biggest files are checked first
+        std::map<std::string, unsigned long> times;
+        std::vector<std::string> order(ThreadExecutor::scheduleFiles(filenames, filesizes, times));
+        ASSERT_EQUALS(4U, order.size());
+        ASSERT_EQUALS("b.cpp c.cpp d.cpp a.cpp", order[0] + " " + order[1] + " " + order[2] + " " + order[3]);
+
+        // a.cpp was slow in an earlier run. The time of d.cpp is estimated
+        // from the time per byte in a.cpp and b.cpp.
+        times["a.cpp"] = 5000;
+        times["b.cpp"] = 1000;
+        times["c.cpp"] = 10;
+        order = ThreadExecutor::scheduleFiles(filenames, filesizes, times);
+        ASSERT_EQUALS(4U, order.size());
+        ASSERT_EQUALS("a.cpp d.cpp b.cpp c.cpp", order[0] + " " + order[1] + " " + order[2] + " " + order[3]);
+    }
+
+    void cost_file()
+    {
+        if (!ThreadExecutor::isEnabled())
+            return;
+
+        const char costFile[] = "threadexecutor.cost";
+        std::vector<std::string> filenames;
+        filenames.push_back("costFile.cpp");
+        std::map<std::string, long> filesizes;
+        Settings settings;
+        settings._jobs = 2;
+        settings.cacheFile = "cppcheck.cache";
+        settings.costFile = costFile;
+
+        // The first run saves the results in the results cache
+        {
+            ThreadExecutor executor(filenames, filesizes, settings, *this);
+            executor.addFileContent("costFile.cpp", "int costFile;\n");
+            executor.check();
+        }
+
+        // The results of the second run come from the cache, the time
+        // of the earlier run is kept
+        {
+            std::ofstream fout(costFile);
+            fout << "123456 costFile.cpp\n";
+        }
+        {
+            ThreadExecutor executor(filenames, filesizes, settings, *this);
+            executor.addFileContent("costFile.cpp", "int costFile;\n");
+            executor.check();
+        }
+
+        std::string times;
+        {
+            std::ifstream fin(costFile);
+            std::getline(fin, times);
+        }
+        ASSERT_EQUALS("123456 costFile.cpp", times);
+        std::remove(costFile);
+    }
+
+    /** Keep the progress that is reported */
+    class ProgressLogger : public ErrorLogger
+    {
+    public:
+        ProgressLogger() : statusCount(0)
+        { }
+
+        void reportOut(const std::string &)
+        { }
+        void reportErr(const ErrorLogger::ErrorMessage &)
+        { }
+        void reportProgress(const std::string &filename, const char stage[], const unsigned int value)
+        {
+            std::ostringstream oss;
+            oss << filename << ": " << stage << " " << value << "\n";
+            stages += oss.str();
+        }
+        void reportStatus(unsigned int, unsigned int, long, long)
+        {
+            ++statusCount;
+        }
+
+        std::string stages;
+        unsigned int statusCount;
+    };
+
+    void progress()
+    {
+        if (!ThreadExecutor::isEnabled())
+            return;
+
+        // The children send each stage once to the parent
+        std::vector<std::string> filenames;
+        filenames.push_back("file_1.cpp");
+        filenames.push_back("file_2.cpp");
+        std::map<std::string, long> filesizes;
+        Settings settings;
+        settings._jobs = 1;
+        settings.reportProgress = true;
+        ProgressLogger logger;
+        ThreadExecutor executor(filenames, filesizes, settings, logger);
+        executor.addFileContent("file_1.cpp", "int a;\nint b;\n");
+        executor.addFileContent("file_2.cpp", "int c;\n");
+        executor.check();
+
+        ASSERT_EQUALS(2U, logger.statusCount);
+        ASSERT_EQUALS(std::string::npos, logger.stages.find("file_1.cpp: Preprocessing (get configurations 1) 0\nfile_1.cpp: Preprocessing (get configurations 1) 0\n"));
+        ASSERT(logger.stages.find("file_1.cpp: Preprocessing (get configurations 1) 0\n") < logger.stages.find("file_2.cpp: Preprocessing (get configurations 1) 0\n"));
+        ASSERT(logger.stages.find("file_2.cpp: Preprocessing (get configurations 1) 0\n") != std::string::npos);
+    }
 };
 
 REGISTER_TEST(TestThreadExecutor)
@@ -132,6 +132,7 @@ private:
         TEST_CASE(simplifyKnownVariables40);
         TEST_CASE(simplifyKnownVariables41);    // p=&x; if (p) ..
         TEST_CASE(simplifyKnownVariables42);    // ticket #2031 - known string value after strcpy
+        TEST_CASE(simplifyKnownVariables43);    // variables that are not used after the assignment
         TEST_CASE(simplifyKnownVariablesBailOutAssign);
         TEST_CASE(simplifyKnownVariablesBailOutFor1);
         TEST_CASE(simplifyKnownVariablesBailOutFor2);
@@ -2119,6 +2120,28 @@ private:
         }
     }
 
+    void simplifyKnownVariables43()
+    {
+        {
+            const char code[] = "void f() {\n"
+                                "    int a = 0;\n"
+                                "    int b = 1;\n"
+                                "    x = 2;\n"
+                                "}";
+            ASSERT_EQUALS("void f ( ) {\n;\n\nx = 2 ;\n}", tokenizeAndStringify(code, true));
+        }
+
+        {
+            const char code[] = "int f() {\n"
+                                "    int a = 1;\n"
+                                "    int b = a;\n"
+                                "    int c = b;\n"
+                                "    return c;\n"
+                                "}";
+            ASSERT_EQUALS("int f ( ) {\n;\n\n\nreturn 1 ;\n}", tokenizeAndStringify(code, true));
+        }
+    }
+
     void simplifyKnownVariablesBailOutAssign()
     {
         const char code[] = "int foo() {\n"
@@ -49,14 +49,16 @@ private:
         TEST_CASE(func_uninit_var);     // analyse function calls for: 'int a(int x) { return x+x; }'
         TEST_CASE(func_uninit_pointer); // analyse function calls for: 'void a(int *p) { *p = 0; }'
         TEST_CASE(uninitvar_typeof);    // typeof
+        TEST_CASE(uninitvar_jobs);      // functions are checked in parallel
     }
 
-    void checkUninitVar(const char code[])
+    void checkUninitVar(const char code[], unsigned int checkJobs = 1)
     {
         // Clear the error buffer..
         errout.str("");
 
         Settings settings;
+        settings._checkJobs = checkJobs;
 
         // Tokenize..
         Tokenizer tokenizer(&settings, this);
@@ -1507,7 +1509,26 @@ private:
                        "}\n");
         ASSERT_EQUALS("", errout.str());
     }
+
+    void uninitvar_jobs()
+    {
+        std::string code;
+        for (unsigned int i = 0; i < 12; ++i)
+        {
+            code += "void f" + std::string(1, char('a' + i)) + "() {\n"
+                    "    int a;\n"
+                    "    if (x) { a = 0; }\n"
+                    "    b = a;\n"
+                    "}\n";
+        }
+
+        checkUninitVar(code.c_str(), 1);
+        const std::string serial(errout.str());
+        ASSERT_EQUALS("[test.cpp:4]: (error) Uninitialized variable: a\n", serial.substr(0, serial.find("\n") + 1));
+
+        checkUninitVar(code.c_str(), 3);
+        ASSERT_EQUALS(serial, errout.str());
+    }
 };
 
 REGISTER_TEST(TestUninitVar)
-
@@ -93,6 +93,7 @@ private:
         TEST_CASE(localvaralias8);
         TEST_CASE(localvaralias9); // ticket #1996
         TEST_CASE(localvaralias10); // ticket #2004
+        TEST_CASE(localvaralias11); // many variables
         TEST_CASE(localvarasm);
         TEST_CASE(localvarstatic);
         TEST_CASE(localvardynamic);
@@ -2281,6 +2282,23 @@ private:
         ASSERT_EQUALS("", errout.str());
     }
 
+    void localvaralias11()
+    {
+        // the aliases are not in the first 64 variables
+        std::ostringstream code;
+        code << "void foo()\n"
+             << "{\n"
+             << "    int *b;\n";
+        for (int i = 0; i < 70; ++i)
+            code << "    int v" << i << " = 0; bar(v" << i << ");\n";
+        code << "    int a;\n"
+             << "    b = &a;\n"
+             << "    *b = 0;\n"
+             << "}\n";
+        functionVariableUsage(code.str().c_str());
+        ASSERT_EQUALS("[test.cpp:74]: (style) Variable 'a' is assigned a value that is never used\n", errout.str());
+    }
+
     void localvarasm()
     {
         functionVariableUsage("void foo(int &b)\n"